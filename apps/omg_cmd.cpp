@@ -37,6 +37,7 @@ NLOHMANN_JSON_SERIALIZE_ENUM(LimitingMethod, {
 
 enum class Triangulator {
     TRIANGLE,
+    TRIANGLE_PARALLEL,
     JIGSAW,
     INVALID = -1
 };
@@ -44,75 +45,52 @@ enum class Triangulator {
 NLOHMANN_JSON_SERIALIZE_ENUM(Triangulator, {
     {Triangulator::INVALID, nullptr},
     {Triangulator::TRIANGLE, "triangle"},
+    {Triangulator::TRIANGLE_PARALLEL, "triangle_parallel"},
     {Triangulator::JIGSAW, "jigsaw"}
 })
 
 
 enum class FileFormat {
     VTK,
+    VTK_BINARY,
+    VTU,
     OFF,
     NOD2D,
+    UGRID,
     INVALID = -1
 };
 
 NLOHMANN_JSON_SERIALIZE_ENUM(FileFormat, {
     {FileFormat::INVALID, nullptr},
     {FileFormat::VTK, "vtk"},
+    {FileFormat::VTK_BINARY, "vtk_binary"},
+    {FileFormat::VTU, "vtu"},
     {FileFormat::OFF, "off"},
-    {FileFormat::NOD2D, "nod2d"}
+    {FileFormat::NOD2D, "nod2d"},
+    {FileFormat::UGRID, "ugrid"}
 })
 
 
-int main(int argc, char* args[]) {
-    omg::ScopeTimer timer;
-    std::cout << "========== Ocean Mesh Generation ==========" << std::endl;
-
-    // TODO: change to cmd args
-    // if (argc < 2) {
-    //     std::cout << "Path to a config.json file required!" << std::endl;
-    //     return EXIT_SUCCESS;
-    // }
-    // const std::string filename = args[1];
-    const std::string filename = "../../apps/config.json";
-
-    std::cout << "Reading configuration file ..." << std::endl;
-    nlohmann::json cfg;
-
-    std::ifstream cfg_file(filename);
-    if (!cfg_file.good()) {
-        throw std::runtime_error("Cannot open file: " + filename);
-    }
-
-    cfg_file >> cfg;
+// the pipeline after reading the bathymetry, for data in memory, compressed or tiles loaded on demand
+template<typename Bathymetry>
+static int run(const nlohmann::json& cfg, const omg::LineGraph& poly, const Bathymetry& topo) {
+    // output is written in the background while the mesh is generated,
+    // declared after the bathymetry so pending jobs finish before it is destroyed
+    omg::io::AsyncWriter writer;
 
-    std::cout << "Creating region polygon ..." << std::endl;
-    omg::LineGraph poly;
-
-    const PolyType poly_type = cfg["poly_region"]["type"].get<PolyType>();
-    switch (poly_type) {
-        case PolyType::FILE:
-            poly = omg::io::readPoly(cfg["poly_region"]["path"].get<std::string>());
-            break;
-        case PolyType::RECTANGLE:
-            {
-                omg::AxisAlignedBoundingBox rect;
-                const auto& min = cfg["poly_region"]["min"];
-                rect.min = {min[0].get<omg::real_t>(), min[1].get<omg::real_t>()};
-                const auto& max = cfg["poly_region"]["max"];
-                rect.max = {max[0].get<omg::real_t>(), max[1].get<omg::real_t>()};
+    if (cfg["output"].contains("save_bathymetry")) {
+        const std::string file = cfg["output"]["save_bathymetry"].get<std::string>();
+        if (!file.empty()) {
+            if constexpr (std::is_same_v<Bathymetry, omg::BathymetryData>) {
+                std::cout << "Saving bathymetry ..." << std::endl;
 
-                poly = omg::LineGraph::createRectangle(rect);
+                writer.submit("bathymetry", [&topo, file]() { omg::io::writeLegacyVTK(file, topo); });
+            } else {
+                std::cerr << "Saving the bathymetry is only supported for uncompressed data in memory!" << std::endl;
             }
-            break;
-        default:
-            std::cerr << "Invalid region type!" << std::endl;
-            return EXIT_FAILURE;
+        }
     }
 
-    std::cout << "Reading bathymetry data ..." << std::endl;
-    const std::string nc_filename = cfg["netcdf_bathymetry"].get<std::string>();
-    const omg::BathymetryData topo = omg::io::readNetCDF(nc_filename, poly.computeBoundingBox());
-
     omg::real_t coast_height = 0;
     if (cfg.contains("sea_level")) {
         std::cout << "Setting relative sea level ..." << std::endl;
@@ -161,6 +139,15 @@ int main(int argc, char* args[]) {
         }
     }
 
+    if (cfg["output"].contains("save_size_function")) {
+        const std::string file = cfg["output"]["save_size_function"].get<std::string>();
+        if (!file.empty()) {
+            std::cout << "Saving size function ..." << std::endl;
+            writer.write("size function", omg::ScalarField<omg::real_t>(sf),
+                         [file](const omg::ScalarField<omg::real_t>& s) { omg::io::writeLegacyVTK(file, s); });
+        }
+    }
+
     std::cout << "Creating boundary ..." << std::endl;
     omg::BoundaryGenerator generator(topo, poly, sf);
     const omg::real_t height = cfg["boundary"]["height"].get<omg::real_t>();
@@ -175,6 +162,19 @@ int main(int argc, char* args[]) {
     }
     omg::Boundary coast = generator.generate(height, ignore_islands, true, min_angle);
 
+    if (cfg["output"].contains("save_boundary")) {
+        const std::string file = cfg["output"]["save_boundary"].get<std::string>();
+        if (!file.empty()) {
+            std::cout << "Saving boundary ..." << std::endl;
+
+            std::vector<omg::HEPolygon> polys = coast.getIslands();
+            polys.push_back(coast.getOuter());
+
+            writer.write("boundary", omg::LineGraph::combinePolygons(polys),
+                         [file](const omg::LineGraph& complete) { omg::io::writeLegacyVTK(file, complete); });
+        }
+    }
+
     if (coast.hasIntersections()) {
 
         bool allow_self_intersection = false;
@@ -189,14 +189,27 @@ int main(int argc, char* args[]) {
     }
 
     std::cout << "Preparing triangulation ..." << std::endl;
-    omg::Mesh mesh;
     std::unique_ptr<omg::Triangulator> tri;
 
+    bool interior_seeding = false;
+    if (cfg.contains("interior_seeding")) {
+        interior_seeding = cfg["interior_seeding"].get<bool>();
+    }
+
     const Triangulator triangulator_type = cfg["triangulator"].get<Triangulator>();
     switch (triangulator_type) {
-        case Triangulator::TRIANGLE:
-            tri = std::make_unique<omg::TriangleTriangulator>();
+        case Triangulator::TRIANGLE: {
+            auto triangle = std::make_unique<omg::TriangleTriangulator>();
+            triangle->setInteriorSeeding(interior_seeding);
+            tri = std::move(triangle);
+            break;
+        }
+        case Triangulator::TRIANGLE_PARALLEL: {
+            auto parallel = std::make_unique<omg::ParallelTriangleTriangulator>();
+            parallel->setInteriorSeeding(interior_seeding);
+            tri = std::move(parallel);
             break;
+        }
         case Triangulator::JIGSAW:
             tri = std::make_unique<omg::JigsawTriangulator>();
             break;
@@ -205,66 +218,175 @@ int main(int argc, char* args[]) {
             return EXIT_FAILURE;
     }
 
-    std::cout << "Constructing mesh ..." << std::endl;
-    tri->generateMesh(coast, sf, mesh);
-
-    if (cfg.contains("remeshing_iterations") && triangulator_type == Triangulator::TRIANGLE) {
-        const int iterations = cfg["remeshing_iterations"].get<int>();
-        if (iterations > 0) {
+    int remeshing_iterations = 0;
+    if (cfg.contains("remeshing_iterations") && (triangulator_type == Triangulator::TRIANGLE
+                                                || triangulator_type == Triangulator::TRIANGLE_PARALLEL)) {
+        remeshing_iterations = cfg["remeshing_iterations"].get<int>();
+    }
 
-            std::cout << "Performing remeshing ..." << std::endl;
-            omg::IsotropicRemeshing ir(sf);
-            ir.remesh(mesh, iterations);
-        }
+    const FileFormat format = cfg["output"]["mesh_file_format"].get<FileFormat>();
+    if (format == FileFormat::INVALID) {
+        std::cerr << "Invalid file format!" << std::endl;
+        return EXIT_FAILURE;
     }
 
-    std::cout << "Saving mesh ..." << std::endl;
     std::string mesh_filename = "";
     if (cfg["output"].contains("mesh_file_path")) {
         mesh_filename = cfg["output"]["mesh_file_path"].get<std::string>();
     }
 
-    const FileFormat format = cfg["output"]["mesh_file_format"].get<FileFormat>();
-    switch (format) {
-        case FileFormat::VTK:
-            omg::io::writeLegacyVTK(mesh_filename.empty() ? "out.vtk" : mesh_filename, mesh);
-            break;
-        case FileFormat::OFF:
-            omg::io::writeOff(mesh_filename.empty() ? "out.off" : mesh_filename, mesh);
+    // mesh and bathymetry are not changed anymore and live until join
+    const auto save_mesh = [&](const auto& mesh) {
+        std::cout << "Saving mesh ..." << std::endl;
+
+        switch (format) {
+            case FileFormat::VTK:
+                writer.submit("mesh", [&mesh, mesh_filename]() {
+                    omg::io::writeLegacyVTK(mesh_filename.empty() ? "out.vtk" : mesh_filename, mesh);
+                });
+                break;
+            case FileFormat::VTK_BINARY:
+                writer.submit("mesh", [&mesh, mesh_filename]() {
+                    omg::io::writeLegacyVTK(mesh_filename.empty() ? "out.vtk" : mesh_filename, mesh, true);
+                });
+                break;
+            case FileFormat::VTU:
+                writer.submit("mesh", [&mesh, mesh_filename]() {
+                    omg::io::writeVTU(mesh_filename.empty() ? "out.vtu" : mesh_filename, mesh);
+                });
+                break;
+            case FileFormat::OFF:
+                writer.submit("mesh", [&mesh, mesh_filename]() {
+                    omg::io::writeOff(mesh_filename.empty() ? "out.off" : mesh_filename, mesh);
+                });
+                break;
+            case FileFormat::NOD2D:
+                writer.submit("mesh", [&mesh, &topo, mesh_filename]() {
+                    omg::io::writeNod2D(mesh, topo, mesh_filename);
+                });
+                break;
+            case FileFormat::UGRID:
+                writer.submit("mesh", [&mesh, &topo, mesh_filename]() {
+                    omg::io::writeUGRID(mesh_filename.empty() ? "out.nc" : mesh_filename, mesh, topo);
+                });
+                break;
+            default:
+                break;
+        }
+    };
+
+    // the halfedge structure is only built for remeshing, otherwise the triangle arrays are written directly
+    omg::Mesh mesh;
+    omg::FlatMesh flat_mesh;
+
+    std::cout << "Constructing mesh ..." << std::endl;
+    if (remeshing_iterations > 0) {
+        tri->generateMesh(coast, sf, mesh).print();
+
+        std::cout << "Performing remeshing ..." << std::endl;
+        omg::IsotropicRemeshing ir(sf);
+        ir.remesh(mesh, remeshing_iterations);
+
+        save_mesh(mesh);
+    } else {
+        tri->generateFlatMesh(coast, sf, flat_mesh).print();
+
+        save_mesh(flat_mesh);
+    }
+
+    try {
+        writer.join();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char* args[]) {
+    omg::ScopeTimer timer;
+    std::cout << "========== Ocean Mesh Generation ==========" << std::endl;
+
+    // TODO: change to cmd args
+    // if (argc < 2) {
+    //     std::cout << "Path to a config.json file required!" << std::endl;
+    //     return EXIT_SUCCESS;
+    // }
+    // const std::string filename = args[1];
+    const std::string filename = "../../apps/config.json";
+
+    std::cout << "Reading configuration file ..." << std::endl;
+    nlohmann::json cfg;
+
+    std::ifstream cfg_file(filename);
+    if (!cfg_file.good()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    cfg_file >> cfg;
+
+    std::cout << "Creating region polygon ..." << std::endl;
+    omg::LineGraph poly;
+
+    const PolyType poly_type = cfg["poly_region"]["type"].get<PolyType>();
+    switch (poly_type) {
+        case PolyType::FILE:
+            poly = omg::io::readPoly(cfg["poly_region"]["path"].get<std::string>());
             break;
-        case FileFormat::NOD2D:
-            omg::io::writeNod2D(mesh, topo, mesh_filename);
+        case PolyType::RECTANGLE:
+            {
+                omg::AxisAlignedBoundingBox rect;
+                const auto& min = cfg["poly_region"]["min"];
+                rect.min = {min[0].get<omg::real_t>(), min[1].get<omg::real_t>()};
+                const auto& max = cfg["poly_region"]["max"];
+                rect.max = {max[0].get<omg::real_t>(), max[1].get<omg::real_t>()};
+
+                poly = omg::LineGraph::createRectangle(rect);
+            }
             break;
         default:
-            std::cerr << "Invalid file format!" << std::endl;
+            std::cerr << "Invalid region type!" << std::endl;
             return EXIT_FAILURE;
     }
 
-    if (cfg["output"].contains("save_bathymetry")) {
-        const std::string file = cfg["output"]["save_bathymetry"].get<std::string>();
-        if (!file.empty()) {
-            std::cout << "Saving bathymetry ..." << std::endl;
-            omg::io::writeLegacyVTK(file, topo);
-        }
+    std::cout << "Reading bathymetry data ..." << std::endl;
+    const std::string nc_filename = cfg["netcdf_bathymetry"].get<std::string>();
+    unsigned int read_threads = 0;
+    if (cfg.contains("read_threads")) {
+        read_threads = cfg["read_threads"].get<unsigned int>();
     }
-    if (cfg["output"].contains("save_size_function")) {
-        const std::string file = cfg["output"]["save_size_function"].get<std::string>();
-        if (!file.empty()) {
-            std::cout << "Saving size function ..." << std::endl;
-            omg::io::writeLegacyVTK(file, sf);
-        }
+
+    std::string cache_filename;
+    if (cfg.contains("bathymetry_cache")) {
+        cache_filename = cfg["bathymetry_cache"].get<std::string>();
     }
-    if (cfg["output"].contains("save_boundary")) {
-        const std::string file = cfg["output"]["save_boundary"].get<std::string>();
-        if (!file.empty()) {
-            std::cout << "Saving boundary ..." << std::endl;
 
-            std::vector<omg::HEPolygon> polys = coast.getIslands();
-            polys.push_back(coast.getOuter());
+    std::size_t memory_limit = 0;
+    if (cfg.contains("bathymetry_memory_limit")) {
+        memory_limit = cfg["bathymetry_memory_limit"].get<std::size_t>();
+    }
 
-            const omg::LineGraph complete = omg::LineGraph::combinePolygons(polys);
+    if (memory_limit > 0) {
+        const auto topo = omg::io::openNetCDFTiled(nc_filename, poly.computeBoundingBox(), 256, memory_limit << 20);
+        return run(cfg, poly, *topo);
+    }
 
-            omg::io::writeLegacyVTK(file, complete);
-        }
+    bool compress = false;
+    if (cfg.contains("compress_bathymetry")) {
+        compress = cfg["compress_bathymetry"].get<bool>();
     }
+
+    if (compress) {
+        const omg::CompressedBathymetryData topo = omg::io::readNetCDFCompressed(nc_filename, poly.computeBoundingBox());
+        return run(cfg, poly, topo);
+    }
+
+    const omg::BathymetryData topo = cache_filename.empty()
+        ? omg::io::readNetCDF(nc_filename, poly.computeBoundingBox(), read_threads)
+        : omg::io::readNetCDFCached(nc_filename, poly.computeBoundingBox(), cache_filename, read_threads);
+
+    return run(cfg, poly, topo);
 }
+
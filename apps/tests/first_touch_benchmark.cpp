@@ -0,0 +1,57 @@
+#include <iostream>
+
+#include <omg.h>
+
+// compares grids placed by a serial zero fill with the parallel first touch of ScalarField
+// run with OMP_PROC_BIND=spread OMP_PLACES=cores on a multi socket machine to see the difference
+
+const std::size_t SIZE = 8192;
+const int REPETITIONS = 20;
+
+// same access pattern as the gradient limiting
+template<typename Grid>
+void smooth(const Grid& in, Grid& out) {
+    #pragma omp parallel for schedule(static)
+    for (std::size_t j = 1; j < SIZE - 1; j++) {
+        for (std::size_t i = 1; i < SIZE - 1; i++) {
+            const std::size_t idx = i + j * SIZE;
+            out[idx] = 0.2 * (in[idx] + in[idx - 1] + in[idx + 1] + in[idx - SIZE] + in[idx + SIZE]);
+        }
+    }
+}
+
+template<typename Grid>
+void run(const std::string& name, Grid& a, Grid& b) {
+    omg::ScopeTimer timer(name);
+
+    for (int r = 0; r < REPETITIONS; r++) {
+        smooth(a, b);
+        std::swap(a, b);
+    }
+}
+
+int main() {
+    const omg::AxisAlignedBoundingBox aabb = {{0, 0}, {1, 1}};
+
+    {
+        // old behavior: the whole grid is placed by the thread calling resize
+        std::vector<omg::real_t> a(SIZE * SIZE, 1), b(SIZE * SIZE, 0);
+        run("Serial first touch", a, b);
+    }
+
+    {
+        omg::ScalarField<omg::real_t> a(aabb, {SIZE, SIZE}), b(aabb, {SIZE, SIZE});
+        std::fill(a.grid().begin(), a.grid().end(), 1);
+        run("Parallel first touch", a.grid(), b.grid());
+    }
+
+    omg::gridAllocationPolicy().huge_pages = true;
+
+    {
+        omg::ScalarField<omg::real_t> a(aabb, {SIZE, SIZE}), b(aabb, {SIZE, SIZE});
+        std::fill(a.grid().begin(), a.grid().end(), 1);
+        run("Parallel first touch with huge pages", a.grid(), b.grid());
+    }
+
+    return 0;
+}
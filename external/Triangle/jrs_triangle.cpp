@@ -30,22 +30,31 @@
 
 #define REAL double
 
-#include <functional>
-
 namespace jrs {  // wrap Triangle in a C++ namespace to avoid conflicts
 
-static std::function<int(REAL*, REAL*, REAL*, REAL)> triunsuitable_callback;  // callback function for external use
+typedef int (*triunsuitable_func)(REAL* triorg, REAL* tridest, REAL* triapex, REAL area, void* user_data);
+
+// callback function for external use, one per thread
+static thread_local triunsuitable_func triunsuitable_callback = nullptr;
+static thread_local void* triunsuitable_user_data = nullptr;
 
-void set_triunsuitable_callback(std::function<int(REAL*, REAL*, REAL*, REAL)> callback)
+void set_triunsuitable_callback(triunsuitable_func callback, void* user_data)
 {
     triunsuitable_callback = callback;
+    triunsuitable_user_data = user_data;
+}
+
+void get_triunsuitable_callback(triunsuitable_func& callback, void*& user_data)
+{
+    callback = triunsuitable_callback;
+    user_data = triunsuitable_user_data;
 }
 
 int triunsuitable(REAL* triorg, REAL* tridest, REAL* triapex, REAL area)  // triunsuitable used in triangle.c is implemented here
 {
     if (triunsuitable_callback)
     {
-        return triunsuitable_callback(triorg, tridest, triapex, area);
+        return triunsuitable_callback(triorg, tridest, triapex, area, triunsuitable_user_data);
     }
     else
     {
@@ -18,9 +18,39 @@ namespace jrs {  // wrap Triangle in a C++ namespace to avoid conflicts
 
 #include "triangle/triangle.h"
 
-#include <functional>
-
-void set_triunsuitable_callback(std::function<int(REAL*, REAL*, REAL*, REAL)> callback);
+// user test for the -u switch, user_data is passed through unchanged
+typedef int (*triunsuitable_func)(REAL* triorg, REAL* tridest, REAL* triapex, REAL area, void* user_data);
+
+// the callback is stored per thread and only used by triangulate calls on the same thread,
+// so several triangulations can run concurrently on different threads
+// a null callback restores the default test of triangle.c
+void set_triunsuitable_callback(triunsuitable_func callback, void* user_data);
+
+void get_triunsuitable_callback(triunsuitable_func& callback, void*& user_data);
+
+// sets the callback of this thread while in scope and restores the previous one afterwards,
+// also if triangulate or the callback throws
+class TriunsuitableScope {
+public:
+    TriunsuitableScope(triunsuitable_func callback, void* user_data) {
+        get_triunsuitable_callback(previous_callback, previous_user_data);
+        set_triunsuitable_callback(callback, user_data);
+    }
+
+    ~TriunsuitableScope() {
+        set_triunsuitable_callback(previous_callback, previous_user_data);
+    }
+
+    TriunsuitableScope(const TriunsuitableScope&) = delete;
+    TriunsuitableScope& operator=(const TriunsuitableScope&) = delete;
+
+private:
+    triunsuitable_func previous_callback;
+    void* previous_user_data;
+};
+
+// the exact arithmetic constants and the random seed of triangle.c are made thread_local
+// by patch_globals.cmake when triangle is fetched, so triangulate can run on several threads at once
 
 }
 
@@ -0,0 +1,24 @@
+# makes the global state of triangle.c thread_local, triangle.c is compiled as C++ in jrs_triangle.cpp
+# the exact arithmetic constants and the random seed are reset by every triangulate call,
+# so each thread only needs its own copy, applying the patch twice changes nothing
+
+file(READ "${TRIANGLE_SOURCE}" source)
+
+foreach (global
+    "REAL splitter;"
+    "REAL epsilon;"
+    "REAL resulterrbound;"
+    "REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;"
+    "REAL iccerrboundA, iccerrboundB, iccerrboundC;"
+    "REAL o3derrboundA, o3derrboundB, o3derrboundC;"
+    "unsigned long randomseed;")
+  string(REPLACE "\n${global}" "\nthread_local ${global}" source "${source}")
+
+  # every global has to be patched, a changed declaration would silently stay shared between threads
+  string(FIND "${source}" "\nthread_local ${global}" found)
+  if (found EQUAL -1)
+    message(FATAL_ERROR "Could not make \"${global}\" in ${TRIANGLE_SOURCE} thread_local")
+  endif ()
+endforeach ()
+
+file(WRITE "${TRIANGLE_SOURCE}" "${source}")
@@ -1,28 +1,24 @@
 #pragma once
 
 #include <topology/scalar_field.h>
+#include <topology/scalar_field_pyramid.h>
 
 namespace omg {
 namespace analysis {
 
-template<typename T, typename S = T>  // TODO: refactor
-inline ScalarField<S> difference(const ScalarField<T>& f1, const ScalarField<T>& f2) {
+namespace internal {
 
-    // use highest resolution
-    vec2_t highest_res(0);
-    highest_res[0] = std::min(f1.getCellSize()[0], f2.getCellSize()[0]);
-    highest_res[1] = std::min(f1.getCellSize()[1], f2.getCellSize()[1]);
+template<typename S, typename Sample>
+inline ScalarField<S> sampleDifference(const AxisAlignedBoundingBox& bb1, const AxisAlignedBoundingBox& bb2,
+                                       const vec2_t& resolution, const Sample& sample) {
 
     // compute intersection of bounding boxes
-    const AxisAlignedBoundingBox& bb1 = f1.getBoundingBox();
-    const AxisAlignedBoundingBox& bb2 = f2.getBoundingBox();
-
     AxisAlignedBoundingBox aabb;
     aabb.min = vec2_t(std::max(bb1.min[0], bb2.min[0]), std::max(bb1.min[1], bb2.min[1]));
     aabb.max = vec2_t(std::min(bb1.max[0], bb2.max[0]), std::min(bb1.max[1], bb2.max[1]));
 
     // calculate grid size and round
-    const size2_t grid_size = toSize2((aabb.max - aabb.min) / highest_res + vec2_t(1.5));
+    const size2_t grid_size = toSize2((aabb.max - aabb.min) / resolution + vec2_t(1.5));
 
     // create new scalar field
     ScalarField<S> diff(aabb, grid_size);
@@ -32,14 +28,44 @@ inline ScalarField<S> difference(const ScalarField<T>& f1, const ScalarField<T>&
         for (std::size_t j = 0; j < grid_size[1]; j++) {
 
             const vec2_t pos = vec2_t(i, j) * diff.getCellSize() + aabb.min;
-            // weird template issue
-            diff.grid(i, j) = f1.template getValue<S>(pos) - f2.template getValue<S>(pos);
+            diff.grid(i, j) = sample(pos);
         }
     }
 
     return diff;
 }
 
+}
+
+template<typename T, typename S = T>  // TODO: refactor
+inline ScalarField<S> difference(const ScalarField<T>& f1, const ScalarField<T>& f2) {
+
+    // use highest resolution
+    vec2_t highest_res(0);
+    highest_res[0] = std::min(f1.getCellSize()[0], f2.getCellSize()[0]);
+    highest_res[1] = std::min(f1.getCellSize()[1], f2.getCellSize()[1]);
+
+    return internal::sampleDifference<S>(f1.getBoundingBox(), f2.getBoundingBox(), highest_res,
+                                         [&](const vec2_t& pos) {
+        // weird template issue
+        return f1.template getValue<S>(pos) - f2.template getValue<S>(pos);
+    });
+}
+
+// difference at a given cell size, both fields are sampled from the mean pyramid level matching the cell size
+// so comparing a fine with a coarse field does not read the complete fine grid
+template<typename T, typename S = T>
+inline ScalarField<S> difference(const ScalarFieldPyramid<T>& p1, const ScalarFieldPyramid<T>& p2, real_t cell_size) {
+
+    const ScalarField<T>& f1 = p1.getLevel(p1.selectLevel(cell_size), Reduction::MEAN);
+    const ScalarField<T>& f2 = p2.getLevel(p2.selectLevel(cell_size), Reduction::MEAN);
+
+    return internal::sampleDifference<S>(f1.getBoundingBox(), f2.getBoundingBox(), vec2_t(cell_size),
+                                         [&](const vec2_t& pos) {
+        return f1.template getValue<S>(pos) - f2.template getValue<S>(pos);
+    });
+}
+
 template<typename T>
 inline T norm(const ScalarField<T>& field) {
     const size2_t grid_size = field.getGridSize();
@@ -6,6 +6,8 @@
 
 #include <boundary/marching_quads.h>
 #include <boundary/simplification.h>
+#include <topology/compressed_scalar_field.h>
+#include <topology/tiled_scalar_field.h>
 #include <geometry/line_intersection.h>
 #include <util.h>
 #include <analysis/assertions.h>
@@ -14,14 +16,16 @@
 
 namespace omg {
 
-BoundaryGenerator::BoundaryGenerator(const BathymetryData& data, const LineGraph& poly, const SizeFunction& size)
+template<typename Bathymetry>
+BoundaryGenerator<Bathymetry>::BoundaryGenerator(const Bathymetry& data, const LineGraph& poly, const SizeFunction& size)
     : data(data), size(size) {
 
     // convert LineGraph to region HEPolygon
     convertToRegion(poly);
 }
 
-Boundary BoundaryGenerator::generate(real_t height, bool ignore_islands, bool simplify, real_t min_angle_deg) {
+template<typename Bathymetry>
+Boundary BoundaryGenerator<Bathymetry>::generate(real_t height, bool ignore_islands, bool simplify, real_t min_angle_deg) {
     this->height = height;
 
     Boundary boundary;
@@ -69,7 +73,7 @@ Boundary BoundaryGenerator::generate(real_t height, bool ignore_islands, bool si
     // find and remove the outer polygon
     // special case: region polygon is completely on water (below boundary height)
     const vec2_t& first_corner = region.startPoint(*region.halfEdges().begin());
-    const bool is_water = data.getValue<real_t>(first_corner) < height;
+    const bool is_water = data.template getValue<real_t>(first_corner) < height;
 
     HEPolygon outer;
     // no intersections and one corner is below boundary height
@@ -100,7 +104,8 @@ Boundary BoundaryGenerator::generate(real_t height, bool ignore_islands, bool si
     return boundary;
 }
 
-void BoundaryGenerator::convertToRegion(const LineGraph& poly) {
+template<typename Bathymetry>
+void BoundaryGenerator<Bathymetry>::convertToRegion(const LineGraph& poly) {
     ScopeTimer timer("Convert region");
 
     // check for self-intersections
@@ -124,7 +129,8 @@ void BoundaryGenerator::convertToRegion(const LineGraph& poly) {
     region = std::move(cycles[0]);
 }
 
-void BoundaryGenerator::computeIntersections(const LineGraph& coast, IntersectionList& intersections) const {
+template<typename Bathymetry>
+void BoundaryGenerator<Bathymetry>::computeIntersections(const LineGraph& coast, IntersectionList& intersections) const {
     // TODO: special cases
     ScopeTimer timer("Compute intersections");
 
@@ -202,13 +208,14 @@ void BoundaryGenerator::computeIntersections(const LineGraph& coast, Intersectio
     }
 }
 
-void BoundaryGenerator::clampToRegion(LineGraph& coast, AdjacencyList& adjacency, const IntersectionList& intersections) const {
+template<typename Bathymetry>
+void BoundaryGenerator<Bathymetry>::clampToRegion(LineGraph& coast, AdjacencyList& adjacency, const IntersectionList& intersections) const {
 
     // get first region corner
     const vec2_t& first_corner = region.startPoint(*region.halfEdges().begin());
     // if the corner is below iso height, cut the coast off
     // and use the region polygon from the last to the first intersection
-    const bool use_region_boundary = data.getValue<real_t>(first_corner) < height;  // TODO: doesn't always work?
+    const bool use_region_boundary = data.template getValue<real_t>(first_corner) < height;  // TODO: doesn't always work?
 
     // skip every second intersection, because it was already used
     // use_region_boundary determines if the even or odd ones are skipped
@@ -266,7 +273,8 @@ void BoundaryGenerator::clampToRegion(LineGraph& coast, AdjacencyList& adjacency
     }
 }
 
-BoundaryGenerator::Intersection BoundaryGenerator::getNextIntersection(const IntersectionList& intersections,
+template<typename Bathymetry>
+typename BoundaryGenerator<Bathymetry>::Intersection BoundaryGenerator<Bathymetry>::getNextIntersection(const IntersectionList& intersections,
                                                      HEPolygon::HalfEdgeHandle heh, std::size_t intersection_idx,
                                                      std::vector<vec2_t>& corners) const {
 
@@ -290,7 +298,8 @@ BoundaryGenerator::Intersection BoundaryGenerator::getNextIntersection(const Int
     throw std::runtime_error("no next intersection found");
 }
 
-void BoundaryGenerator::cutEdge(LineGraph& coast, AdjacencyList& adjacency, EHandle edge, VHandle cut) const {
+template<typename Bathymetry>
+void BoundaryGenerator<Bathymetry>::cutEdge(LineGraph& coast, AdjacencyList& adjacency, EHandle edge, VHandle cut) const {
     // adjust adjacency list
     // throw vertex outside away and update the vertex inside
 
@@ -321,7 +330,8 @@ void BoundaryGenerator::cutEdge(LineGraph& coast, AdjacencyList& adjacency, EHan
     adjacency.get(cut).push_back(e);
 }
 
-std::vector<HEPolygon> BoundaryGenerator::findCycles(const LineGraph& coast, const AdjacencyList& adjacency) const {
+template<typename Bathymetry>
+std::vector<HEPolygon> BoundaryGenerator<Bathymetry>::findCycles(const LineGraph& coast, const AdjacencyList& adjacency) const {
     ScopeTimer timer("Find cycles");
 
     std::vector<HEPolygon> cycles;
@@ -382,7 +392,8 @@ std::vector<HEPolygon> BoundaryGenerator::findCycles(const LineGraph& coast, con
     return cycles;
 }
 
-std::size_t BoundaryGenerator::findOuterPolygon(const std::vector<HEPolygon>& cycles) {
+template<typename Bathymetry>
+std::size_t BoundaryGenerator<Bathymetry>::findOuterPolygon(const std::vector<HEPolygon>& cycles) {
     // TODO: fix error, when smaller lake is selected
     if (cycles.empty()) {
         throw std::runtime_error("cycles is empty");
@@ -417,7 +428,8 @@ std::size_t BoundaryGenerator::findOuterPolygon(const std::vector<HEPolygon>& cy
     return largest;
 }
 
-void BoundaryGenerator::findIslands(Boundary& boundary, std::vector<HEPolygon>& cycles, bool simplify, real_t min_angle_deg) {
+template<typename Bathymetry>
+void BoundaryGenerator<Bathymetry>::findIslands(Boundary& boundary, std::vector<HEPolygon>& cycles, bool simplify, real_t min_angle_deg) {
     ScopeTimer timer("Create holes");
 
     // move the islands
@@ -460,7 +472,8 @@ void BoundaryGenerator::findIslands(Boundary& boundary, std::vector<HEPolygon>&
     }
 }
 
-bool BoundaryGenerator::enclosesWater(const HEPolygon& poly, const std::vector<HEPolygon>& cycles) const {
+template<typename Bathymetry>
+bool BoundaryGenerator<Bathymetry>::enclosesWater(const HEPolygon& poly, const std::vector<HEPolygon>& cycles) const {
     // test if the polygon surrounds water or land
 
     for (HEPolygon::HalfEdgeHandle heh : poly.halfEdges()) {
@@ -470,7 +483,7 @@ bool BoundaryGenerator::enclosesWater(const HEPolygon& poly, const std::vector<H
         const vec2_t& p2 = poly.endPoint(heh);
 
         // ignore points that are cut corners of the region polygon
-        if (data.getValue<real_t>(p1) < height - 0.1 || data.getValue<real_t>(p2) < height - 0.1) {
+        if (data.template getValue<real_t>(p1) < height - 0.1 || data.template getValue<real_t>(p2) < height - 0.1) {
             continue;
         }
 
@@ -508,4 +521,8 @@ bool BoundaryGenerator::enclosesWater(const HEPolygon& poly, const std::vector<H
     return counter % 2 == 0;
 }
 
+template class BoundaryGenerator<BathymetryData>;
+template class BoundaryGenerator<TiledBathymetryData>;
+template class BoundaryGenerator<CompressedBathymetryData>;
+
 }
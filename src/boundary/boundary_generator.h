@@ -9,15 +9,17 @@
 
 namespace omg {
 
+// instantiated for BathymetryData, TiledBathymetryData and CompressedBathymetryData
+template<typename Bathymetry = BathymetryData>
 class BoundaryGenerator {
 public:
-    BoundaryGenerator(const BathymetryData& data, const LineGraph& poly, const SizeFunction& size);
+    BoundaryGenerator(const Bathymetry& data, const LineGraph& poly, const SizeFunction& size);
 
     Boundary generate(real_t height = 0, bool ignore_islands = false, bool simplify = true, real_t min_angle_deg = 60);
 
 private:
     real_t height;
-    const BathymetryData& data;
+    const Bathymetry& data;
     HEPolygon region;
     const SizeFunction& size;
 
@@ -5,6 +5,8 @@
 
 namespace omg {
 
-LineGraph marchingQuads(const BathymetryData& data, real_t iso_value);
+// instantiated for BathymetryData, TiledBathymetryData and CompressedBathymetryData
+template<typename Bathymetry>
+LineGraph marchingQuads(const Bathymetry& data, real_t iso_value);
 
 }
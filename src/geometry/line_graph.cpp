@@ -73,6 +73,11 @@ LineGraph::EdgeHandle LineGraph::addEdge(VertexHandle v1, VertexHandle v2) {
     return idx;
 }
 
+void LineGraph::reserve(std::size_t num_vertices, std::size_t num_edges) {
+    points.reserve(num_vertices);
+    edges.reserve(num_edges);
+}
+
 void LineGraph::removeEdgesByIndex(std::vector<EdgeHandle>& indices) {
     eraseByIndices(edges, indices.begin(), indices.end());
 }
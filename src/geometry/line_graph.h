@@ -27,6 +27,8 @@ public:
     VertexHandle addVertex(const vec2_t& p);
     EdgeHandle addEdge(VertexHandle v1, VertexHandle v2);
 
+    void reserve(std::size_t num_vertices, std::size_t num_edges);
+
     void removeEdgesByIndex(std::vector<EdgeHandle>& indices);
     void removeVerticesByIndex(std::unordered_set<VertexHandle>& indices);
 
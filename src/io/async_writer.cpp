@@ -0,0 +1,41 @@
+
+#include "async_writer.h"
+
+#include <stdexcept>
+
+namespace omg {
+namespace io {
+
+AsyncWriter::~AsyncWriter() {
+    for (Job& job : jobs) {
+        if (job.result.valid()) {
+            job.result.wait();
+        }
+    }
+}
+
+void AsyncWriter::submit(const std::string& name, std::function<void()> job) {
+    jobs.push_back({name, std::async(std::launch::async, std::move(job))});
+}
+
+void AsyncWriter::join() {
+    std::string errors;
+
+    for (Job& job : jobs) {
+        try {
+            job.result.get();
+        } catch (const std::exception& e) {
+            errors += "\n" + job.name + ": " + e.what();
+        } catch (...) {
+            errors += "\n" + job.name + ": unknown error";
+        }
+    }
+    jobs.clear();
+
+    if (!errors.empty()) {
+        throw std::runtime_error("Error writing output:" + errors);
+    }
+}
+
+}
+}
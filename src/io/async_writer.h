@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace omg {
+namespace io {
+
+// runs output jobs on background threads while the caller continues,
+// errors are collected and reported by join
+class AsyncWriter {
+public:
+    AsyncWriter() = default;
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    // waits for pending jobs, their errors are lost without join
+    ~AsyncWriter();
+
+    // everything the job references must stay alive and unmodified until join
+    void submit(const std::string& name, std::function<void()> job);
+
+    // write an immutable snapshot with writer(const T&), the caller may change or destroy its data afterwards
+    template<typename T, typename Writer>
+    void write(const std::string& name, std::shared_ptr<const T> snapshot, Writer writer) {
+        submit(name, [snapshot = std::move(snapshot), writer = std::move(writer)]() { writer(*snapshot); });
+    }
+
+    template<typename T, typename Writer>
+    void write(const std::string& name, T data, Writer writer) {
+        write(name, std::make_shared<const T>(std::move(data)), std::move(writer));
+    }
+
+    // wait for all jobs, throws if any of them failed
+    void join();
+
+private:
+    struct Job {
+        std::string name;
+        std::future<void> result;
+    };
+
+    std::vector<Job> jobs;
+};
+
+}
+}
@@ -1,61 +1,95 @@
 
 #include "bin32_reader.h"
 
-#include <fstream>
+#include <cmath>
+#include <cstring>
+
+#include <io/mapped_file.h>
 
 namespace omg {
 namespace io {
 
+static inline float readFloat(const char* src, bool swap) {
+    uint32_t bits;
+    std::memcpy(&bits, src, sizeof(bits));
+
+    if (swap) {
+        bits = (bits >> 24) | ((bits >> 8) & 0xff00) | ((bits << 8) & 0xff0000) | (bits << 24);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static const char* mapValues(const MappedFile& file, std::size_t count, const std::string& filename) {
+    if (file.size() / sizeof(float) < count) {
+        throw std::runtime_error("File is too small: " + filename);
+    }
+    return file.data();
+}
+
+static bool isValidAxis(const char* values, std::size_t count, bool swap, real_t limit) {
+    // coordinates have to be finite, inside the limits and ascending
+    const float first = readFloat(values, swap);
+    const float last = readFloat(values + (count - 1) * sizeof(float), swap);
+
+    return std::isfinite(first) && std::isfinite(last) && std::abs(first) <= limit && std::abs(last) <= limit &&
+           first < last;
+}
+
 // dangerous! directly writing and reading binary data to and from files shouldn't be done (without proper formatting)
 // this only exists for compatibility with the old solution
 template<typename T>
 ScalarField<T> readBin32(const std::string& lon_file, const std::string& lat_file, const std::string& topo_file,
                          const size2_t& grid_size) {
 
-    std::ifstream file;
-    std::vector<float> buffer;
-
-    AxisAlignedBoundingBox aabb;
-
-    // read longitude and latitude coordinates
-    const std::string filename[] = {lon_file, lat_file};
-    for (int i = 0; i < 2; i++) {
-
-        file.open(filename[i], std::ios::binary);
-        if (!file.good()) {
-            throw std::runtime_error("Error reading file: " + filename[i]);
-        }
+    // the axes need a first and a last coordinate, the grid defines the number of values in the files
+    if (grid_size[0] < 2 || grid_size[1] < 2) {
+        throw std::runtime_error("grid size must be at least 2x2");
+    }
 
-        buffer.resize(grid_size[i]);
-        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(float));
+    // the files have no header, the byte order is detected from the coordinates
+    const MappedFile lon_map(lon_file);
+    const MappedFile lat_map(lat_file);
 
-        aabb.min[i] = buffer.front();
-        aabb.max[i] = buffer.back();
+    const char* lon = mapValues(lon_map, grid_size[0], lon_file);
+    const char* lat = mapValues(lat_map, grid_size[1], lat_file);
 
-        file.close();
+    bool swap;
+    if (isValidAxis(lon, grid_size[0], false, 360) && isValidAxis(lat, grid_size[1], false, 90)) {
+        swap = false;
+    } else if (isValidAxis(lon, grid_size[0], true, 360) && isValidAxis(lat, grid_size[1], true, 90)) {
+        swap = true;
+    } else {
+        throw std::runtime_error("Could not detect the byte order of: " + lon_file);
     }
 
-    // read elevation
-    file.open(topo_file, std::ios::binary);
-    if (!file.good()) {
-        throw std::runtime_error("Error reading file: " + topo_file);
-    }
+    AxisAlignedBoundingBox aabb;
+    aabb.min = vec2_t(readFloat(lon, swap), readFloat(lat, swap));
+    aabb.max = vec2_t(readFloat(lon + (grid_size[0] - 1) * sizeof(float), swap),
+                      readFloat(lat + (grid_size[1] - 1) * sizeof(float), swap));
 
-    buffer.resize(grid_size[0] * grid_size[1]);
-    file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(float));
+    // read elevation
+    const MappedFile topo_map(topo_file);
+    const char* topo = mapValues(topo_map, grid_size[0] * grid_size[1], topo_file);
 
-    file.close();
+    ScalarField<T> data(aabb, grid_size);
+    T* grid = data.grid().data();
 
-    ScalarField<T> topo(aabb, grid_size);
+    // convert to correct type, rows are distributed like in the first touch of the grid
+    #pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < grid_size[1]; j++) {
+        const char* src = topo + j * grid_size[0] * sizeof(float);
+        T* dst = grid + j * grid_size[0];
 
-    std::vector<T>& grid = topo.grid();
-    // convert to correct type
-    for (std::size_t i = 0; i < grid.size(); i++) {
-        grid[i] = static_cast<T>(buffer[i]);
-        assert(static_cast<float>(grid[i]) == buffer[i]);
+        #pragma omp simd
+        for (std::size_t i = 0; i < grid_size[0]; i++) {
+            dst[i] = static_cast<T>(readFloat(src + i * sizeof(float), swap));
+        }
     }
 
-    return topo;
+    return data;
 }
 
 BathymetryData readBin32Topology(const std::string& lon_file, const std::string& lat_file, const std::string& topo_file,
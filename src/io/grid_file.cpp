@@ -0,0 +1,197 @@
+
+#include "grid_file.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <io/mapped_file.h>
+
+namespace omg {
+namespace io {
+
+static const char MAGIC[8] = "OMGGRID";
+static const uint32_t VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// the values start at this offset, the header is padded with zeros
+static const std::size_t DATA_OFFSET = 128;
+
+struct GridFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;  // BYTE_ORDER_MARK in the byte order of the writer
+    uint32_t value_type;
+    uint32_t periodic;
+    uint64_t grid_size[2];
+    double aabb[4];  // min x, min y, max x, max y
+    uint64_t checksum;
+};
+
+static_assert(sizeof(GridFileHeader) <= DATA_OFFSET, "grid file header too large");
+
+template<typename T>
+struct GridValueType;
+
+template<>
+struct GridValueType<int16_t> {
+    static const uint32_t value = 1;
+};
+
+template<>
+struct GridValueType<real_t> {
+    static const uint32_t value = 2;
+};
+
+
+static void hashBytes(uint64_t& hash, const void* data, std::size_t size) {
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+}
+
+uint64_t sourceChecksum(const std::string& source_file, const AxisAlignedBoundingBox& aabb) {
+    uint64_t hash = 0xcbf29ce484222325;
+
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::weakly_canonical(source_file, error);
+    if (error) {
+        path = source_file;
+    }
+
+    const std::string name = path.string();
+    hashBytes(hash, name.data(), name.size());
+
+    const uint64_t size = std::filesystem::file_size(path, error);
+    hashBytes(hash, &size, sizeof(size));
+
+    const int64_t time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    hashBytes(hash, &time, sizeof(time));
+
+    const real_t box[4] = {aabb.min[0], aabb.min[1], aabb.max[0], aabb.max[1]};
+    hashBytes(hash, box, sizeof(box));
+
+    return hash;
+}
+
+static bool isCompatible(const GridFileHeader& header) {
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+           header.byte_order == BYTE_ORDER_MARK;
+}
+
+template<typename T>
+static void writeGrid(const std::string& filename, const ScalarField<T>& data, uint64_t checksum) {
+
+    GridFileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.value_type = GridValueType<T>::value;
+    header.periodic = data.isPeriodic();
+    header.grid_size[0] = data.getGridSize()[0];
+    header.grid_size[1] = data.getGridSize()[1];
+    header.aabb[0] = data.getBoundingBox().min[0];
+    header.aabb[1] = data.getBoundingBox().min[1];
+    header.aabb[2] = data.getBoundingBox().max[0];
+    header.aabb[3] = data.getBoundingBox().max[1];
+    header.checksum = checksum;
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+
+    char padded[DATA_OFFSET] = {};
+    std::memcpy(padded, &header, sizeof(header));
+
+    file.write(padded, DATA_OFFSET);
+    file.write(reinterpret_cast<const char*>(data.grid().data()), data.grid().size() * sizeof(T));
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+}
+
+template<typename T>
+static ScalarField<T> readGrid(const std::string& filename) {
+
+    const MappedFile file(filename);
+
+    GridFileHeader header;
+    if (file.size() < DATA_OFFSET) {
+        throw std::runtime_error("Invalid grid file: " + filename);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (!isCompatible(header)) {
+        throw std::runtime_error("Invalid grid file or wrong byte order: " + filename);
+    }
+    if (header.value_type != GridValueType<T>::value) {
+        throw std::runtime_error("Grid file has the wrong value type: " + filename);
+    }
+
+    const size2_t grid_size(header.grid_size[0], header.grid_size[1]);
+    if (file.size() < DATA_OFFSET + grid_size[0] * grid_size[1] * sizeof(T)) {
+        throw std::runtime_error("Grid file is too small: " + filename);
+    }
+
+    AxisAlignedBoundingBox aabb;
+    aabb.min = vec2_t(header.aabb[0], header.aabb[1]);
+    aabb.max = vec2_t(header.aabb[2], header.aabb[3]);
+
+    ScalarField<T> data(aabb, grid_size, header.periodic != 0);
+
+    // copy rows in parallel, with the same distribution as the first touch of the grid
+    const char* values = file.data() + DATA_OFFSET;
+    const std::size_t row_bytes = grid_size[0] * sizeof(T);
+
+    #pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < grid_size[1]; j++) {
+        std::memcpy(data.grid().data() + j * grid_size[0], values + j * row_bytes, row_bytes);
+    }
+
+    return data;
+}
+
+
+void writeGridFile(const std::string& filename, const BathymetryData& data, uint64_t checksum) {
+    writeGrid(filename, data, checksum);
+}
+
+void writeGridFile(const std::string& filename, const ScalarField<real_t>& data, uint64_t checksum) {
+    writeGrid(filename, data, checksum);
+}
+
+BathymetryData readBathymetryGridFile(const std::string& filename) {
+    return readGrid<int16_t>(filename);
+}
+
+ScalarField<real_t> readRealGridFile(const std::string& filename) {
+    return readGrid<real_t>(filename);
+}
+
+bool isValidBathymetryGridFile(const std::string& filename, uint64_t checksum) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        return false;
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file.tellg());
+
+    GridFileHeader header;
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file.good() || !isCompatible(header) || header.value_type != GridValueType<int16_t>::value) {
+        return false;
+    }
+
+    const std::size_t data_size = header.grid_size[0] * header.grid_size[1] * sizeof(int16_t);
+    return header.checksum == checksum && file_size >= DATA_OFFSET + data_size;
+}
+
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <topology/scalar_field.h>
+
+namespace omg {
+namespace io {
+
+// native binary grid format used to cache bathymetry crops:
+// a fixed header (bounding box, grid size, value type, source checksum) followed by the raw values,
+// aligned to 64 bytes in native byte order
+
+// identifies a crop of a source file by its path, size, modification time and the requested bounding box
+uint64_t sourceChecksum(const std::string& source_file, const AxisAlignedBoundingBox& aabb);
+
+void writeGridFile(const std::string& filename, const BathymetryData& data, uint64_t checksum = 0);
+
+void writeGridFile(const std::string& filename, const ScalarField<real_t>& data, uint64_t checksum = 0);
+
+BathymetryData readBathymetryGridFile(const std::string& filename);
+
+ScalarField<real_t> readRealGridFile(const std::string& filename);
+
+// true if the file exists, can be read on this machine, stores bathymetry and has the given checksum
+bool isValidBathymetryGridFile(const std::string& filename, uint64_t checksum);
+
+}
+}
@@ -0,0 +1,81 @@
+
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OMG_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace omg {
+namespace io {
+
+#ifdef OMG_HAS_MMAP
+
+MappedFile::MappedFile(const std::string& filename) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Error mapping file: " + filename);
+        }
+        ptr = static_cast<const char*>(p);
+
+        // files are usually read front to back
+        madvise(p, length, MADV_SEQUENTIAL);
+    }
+
+    // the mapping stays valid without the file descriptor
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (ptr) {
+        munmap(const_cast<char*>(ptr), length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+
+    if (!file.good()) {
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+
+    ptr = buffer.data();
+    length = buffer.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+}
+}
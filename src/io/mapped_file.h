@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace omg {
+namespace io {
+
+// read-only view of a complete file, memory mapped where the platform supports it
+// otherwise the file is read into memory
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    inline const char* data() const { return ptr; }
+    inline std::size_t size() const { return length; }
+
+private:
+    const char* ptr = nullptr;
+    std::size_t length = 0;
+
+    std::vector<char> buffer;  // only used without mmap
+};
+
+}
+}
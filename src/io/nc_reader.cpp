@@ -3,8 +3,20 @@
 
 #include "nc_reader.h"
 
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+
 #include <netcdf>
-#include <functional>
+
+#include <io/grid_file.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace omg {
 namespace io {
@@ -12,6 +24,8 @@ namespace io {
 static const AxisAlignedBoundingBox EVERYTHING;
 static const real_t MAX_LON_COORD = 180;
 static const real_t MIN_LON_COORD = -180;
+static const std::size_t MAX_CHUNK_CACHE = std::size_t(256) << 20;
+static const std::size_t CONVERSION_BUFFER_SIZE = std::size_t(1) << 20;  // float values
 
 static bool startsWith(const std::string& str, const std::string& expr) {
     if (str.size() < expr.size()) {
@@ -66,86 +80,84 @@ static netCDF::NcVar getAndCheckVar(const netCDF::NcFile& data_file, const std::
 }
 
 
-// struct to unify coordinate access
+// coordinate axis read in one bulk call, shared by all readers of the same file
 struct Coordinate {
 
-    Coordinate(const netCDF::NcVar var, real_t (*getFromVar)(const netCDF::NcVar& var, std::size_t idx))
-        : var(var), getFromVar(getFromVar) {}
+    Coordinate(const netCDF::NcVar var, std::shared_ptr<const std::vector<real_t>> values)
+        : var(var), values(std::move(values)) {}
 
     const netCDF::NcVar var;
 
     real_t get(std::size_t idx) const {
-        return getFromVar(var, idx);
+        return (*values)[idx];
     }
 
-    real_t (*getFromVar)(const netCDF::NcVar& var, std::size_t idx);
+    std::shared_ptr<const std::vector<real_t>> values;
 };
 
-struct DataHandle {
+static std::shared_ptr<const std::vector<real_t>> readAxis(const std::string& filename, const netCDF::NcVar& var) {
+    // axes are cached per file and variable, the modification time detects changed files
 
-    DataHandle(const netCDF::NcVar ele, Coordinate lon, Coordinate lat, const AxisAlignedBoundingBox& aabb)
-        : elevation(ele), longitude(lon), latitude(lat), aabb(aabb) {}
+    struct CachedAxis {
+        std::filesystem::file_time_type time;
+        std::shared_ptr<const std::vector<real_t>> values;
+    };
 
-    const netCDF::NcVar elevation;
+    static std::mutex mutex;
+    static std::map<std::string, CachedAxis> cache;
 
-    Coordinate longitude;
-    Coordinate latitude;
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::weakly_canonical(filename, error);
+    if (error) {
+        path = filename;
+    }
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
 
-    const AxisAlignedBoundingBox& aabb;
-};
+    const std::string key = path.string() + ":" + var.getName();
 
-static std::size_t getClosestIndexBelow(const Coordinate& data, real_t coordinate) {
-    // search for the highest index with a coordinate lower than the given one
-    // assumes coordinates are ordered ascending (according to http://cfconventions.org)
+    const std::lock_guard lock(mutex);
 
-    if (data.var.getDimCount() != 1) {
-        throw std::runtime_error("Only one-dimensional data is allowed");
+    const auto it = cache.find(key);
+    if (it != cache.end() && it->second.time == time) {
+        return it->second.values;
     }
-    const std::size_t dim = data.var.getDim(0).getSize();
-
-    const real_t c0 = data.get(0);
-    const real_t c1 = data.get(dim - 1);
 
-    if (coordinate < c0 || coordinate > c1) {
-        throw std::runtime_error("Coordinate is not included in the dataset");
+    if (var.getDimCount() != 1) {
+        throw std::runtime_error("Only one-dimensional data is allowed");
     }
 
-    // compute step size
-    const real_t step = (c1 - c0) / dim;
+    auto values = std::make_shared<std::vector<real_t>>(var.getDim(0).getSize());
+    var.getVar(values->data());
 
-    // estimate search position
-    std::size_t idx = (coordinate - c0) / step + 1;
-    if (idx >= dim) {
-        idx = dim - 1;
-    }
+    cache[key] = {time, values};
+    return values;
+}
 
-    real_t v = data.get(idx);
+struct DataHandle {
 
-    // increase until above
-    while (v < coordinate) {
-        idx++;
+    DataHandle(const netCDF::NcVar ele, Coordinate lon, Coordinate lat, const AxisAlignedBoundingBox& aabb)
+        : elevation(ele), longitude(lon), latitude(lat), aabb(aabb) {}
 
-        if (idx >= dim) {
-            // should never happen
-            throw std::runtime_error("Coordinate is not included in the dataset");
-        }
+    const netCDF::NcVar elevation;
 
-        v = data.get(idx);
-    }
+    Coordinate longitude;
+    Coordinate latitude;
 
-    // decrease until below
-    while (v > coordinate) {
-        idx--;
+    const AxisAlignedBoundingBox& aabb;
+};
 
-        if (idx >= dim) {
-            // rollover should never happen
-            throw std::runtime_error("Coordinate is not included in the dataset");
-        }
+static std::size_t getClosestIndexBelow(const Coordinate& data, real_t coordinate) {
+    // search for the highest index with a coordinate not above the given one
+    // assumes coordinates are ordered ascending (according to http://cfconventions.org)
+
+    const std::vector<real_t>& axis = *data.values;
 
-        v = data.get(idx);
+    if (axis.empty() || coordinate < axis.front() || coordinate > axis.back()) {
+        throw std::runtime_error("Coordinate is not included in the dataset");
     }
 
-    return idx;
+    const auto it = std::upper_bound(axis.begin(), axis.end(), coordinate);
+    return static_cast<std::size_t>(it - axis.begin()) - 1;
 }
 
 static void getIndicesToRead(size2_t& from_idx, size2_t& to_idx, const DataHandle& data) {
@@ -176,56 +188,55 @@ static void getIndicesToRead(size2_t& from_idx, size2_t& to_idx, const DataHandl
         from_idx[1] = getClosestIndexBelow(data.latitude, data.aabb.min[1]);
 
         if (data.aabb.max[0] != MAX_LON_COORD) {
-            to_idx[0] = getClosestIndexBelow(data.longitude, data.aabb.max[0]) + 2;  // + 2 to get above and exclusive
+            // + 2 to get above and exclusive
+            to_idx[0] = std::min(getClosestIndexBelow(data.longitude, data.aabb.max[0]) + 2, to_idx[0]);
         }
-        to_idx[1] = getClosestIndexBelow(data.latitude, data.aabb.max[1]) + 2;
+        to_idx[1] = std::min(getClosestIndexBelow(data.latitude, data.aabb.max[1]) + 2, to_idx[1]);
     }
 }
 
 
-static BathymetryData readGEBCO20(const netCDF::NcFile& data_file, const AxisAlignedBoundingBox& aabb) {
+// variables of a supported file format
+struct Dataset {
 
-    // latitude coordinates for the sample points of the elevation grid
-    const netCDF::NcVar latitude = getAndCheckVar(data_file, "lat", "degrees_north", netCDF::ncDouble, 1);
+    Dataset(const netCDF::NcVar ele, Coordinate lon, Coordinate lat, bool is_float)
+        : elevation(ele), longitude(lon), latitude(lat), is_float(is_float) {}
 
-    // longitude coordinates for the sample points of the elevation grid
-    const netCDF::NcVar longitude = getAndCheckVar(data_file, "lon", "degrees_east", netCDF::ncDouble, 1);
+    const netCDF::NcVar elevation;
 
-    // 2D elevation grid with height in meters as 16 bit signed int
-    const netCDF::NcVar elevation = getAndCheckVar(data_file, "elevation", "m", netCDF::ncShort, 2);
+    Coordinate longitude;
+    Coordinate latitude;
 
-    // set up data handle
-    auto readCoord = [](const netCDF::NcVar& var, std::size_t idx) {
-        real_t value;
-        var.getVar({idx}, &value);
-        return value;
-    };
+    const bool is_float;  // elevation is stored as float instead of int16_t
+};
 
-    Coordinate lat(latitude, readCoord);
-    Coordinate lon(longitude, readCoord);
-    DataHandle handle(elevation, lon, lat, aabb);
+// section of the elevation grid
+struct Hyperslab {
+    size2_t from_idx;
+    size2_t to_idx;  // exclusive
 
-    size2_t from_idx, to_idx;
-    getIndicesToRead(from_idx, to_idx, handle);
+    // the actual bb of the data read may be a little bit larger than requested
+    AxisAlignedBoundingBox aabb;
 
-    const size2_t grid_size = to_idx - from_idx;
+    inline size2_t size() const { return to_idx - from_idx; }
+};
 
-    // read boundary coordinates (assumes coordinates are ordered ascending)
-    AxisAlignedBoundingBox real_aabb;  // the actual bb of the data read may be a little bit larger than requested
-    real_aabb.min = vec2_t(readCoord(longitude, from_idx[0]), readCoord(latitude, from_idx[1]));
-    real_aabb.max = vec2_t(readCoord(longitude, to_idx[0] - 1), readCoord(latitude, to_idx[1] - 1));
+static Dataset openGEBCO20(const netCDF::NcFile& data_file, const std::string& filename) {
 
-    BathymetryData topo(real_aabb, grid_size);
+    // latitude coordinates for the sample points of the elevation grid
+    const netCDF::NcVar latitude = getAndCheckVar(data_file, "lat", "degrees_north", netCDF::ncDouble, 1);
 
-    // read topography data
-    const std::vector<std::size_t> start = {from_idx[1], from_idx[0]};
-    const std::vector<std::size_t> count = {to_idx[1] - from_idx[1], to_idx[0] - from_idx[0]};
-    elevation.getVar(start, count, topo.grid().data());
+    // longitude coordinates for the sample points of the elevation grid
+    const netCDF::NcVar longitude = getAndCheckVar(data_file, "lon", "degrees_east", netCDF::ncDouble, 1);
 
-    return topo;
+    // 2D elevation grid with height in meters as 16 bit signed int
+    const netCDF::NcVar elevation = getAndCheckVar(data_file, "elevation", "m", netCDF::ncShort, 2);
+
+    return Dataset(elevation, Coordinate(longitude, readAxis(filename, longitude)),
+                   Coordinate(latitude, readAxis(filename, latitude)), false);
 }
 
-static BathymetryData readGEBCO08(const netCDF::NcFile& data_file, const AxisAlignedBoundingBox& aabb) {
+static Dataset openGEBCO08(const netCDF::NcFile& data_file, const std::string& filename) {
 
     // latitude coordinates for the sample points of the elevation grid
     const netCDF::NcVar latitude = getVar(data_file, "lat");
@@ -236,135 +247,351 @@ static BathymetryData readGEBCO08(const netCDF::NcFile& data_file, const AxisAli
     // 2D elevation grid with height in meters as float
     const netCDF::NcVar elevation = getVar(data_file, "topo");
 
-    // set up data handle
-    auto readLat = [](const netCDF::NcVar& var, std::size_t idx) {
-        real_t value;
-        var.getVar({idx, 1}, &value);
-        return value;
-    };
+    return Dataset(elevation, Coordinate(longitude, readAxis(filename, longitude)),
+                   Coordinate(latitude, readAxis(filename, latitude)), true);
+}
 
-    auto readLon = [](const netCDF::NcVar& var, std::size_t idx) {
-        real_t value;
-        var.getVar({idx, 0}, &value);
-        return value;
-    };
+static std::string readTitle(const netCDF::NcFile& data_file) {
+    // the title is used to identify the file format
+    const netCDF::NcGroupAtt attribute = data_file.getAtt("title");
+    if (attribute.isNull()) {
+        throw std::runtime_error("No title was found");
+    }
+
+    std::string title;
+    attribute.getValues(title);
+    return title;
+}
+
+static Dataset openDataset(const netCDF::NcFile& data_file, const std::string& filename) {
 
-    Coordinate lat(latitude, readLat);
-    Coordinate lon(longitude, readLon);
-    DataHandle handle(elevation, lon, lat, aabb);
+    // select format
+    const std::string title = readTitle(data_file);
 
-    size2_t from_idx, to_idx;
-    getIndicesToRead(from_idx, to_idx, handle);
+    if (startsWith(title, "The GEBCO_2020 Grid")) {
+        return openGEBCO20(data_file, filename);
+    }
+    if (startsWith(title, "GEBCO_08 TOPOGRAPHY")) {
+        return openGEBCO08(data_file, filename);
+    }
+    throw std::runtime_error("This file format is not supported");
+}
 
-    const size2_t grid_size = to_idx - from_idx;
+static Hyperslab locateHyperslab(const Dataset& dataset, const AxisAlignedBoundingBox& aabb) {
+    Hyperslab slab;
+
+    DataHandle handle(dataset.elevation, dataset.longitude, dataset.latitude, aabb);
+    getIndicesToRead(slab.from_idx, slab.to_idx, handle);
 
     // read boundary coordinates (assumes coordinates are ordered ascending)
-    AxisAlignedBoundingBox real_aabb;  // the actual bb of the data read may be a little bit larger than requested
-    real_aabb.min = vec2_t(readLon(longitude, from_idx[0]), readLat(latitude, from_idx[1]));
-    real_aabb.max = vec2_t(readLon(longitude, to_idx[0] - 1), readLat(latitude, to_idx[1] - 1));
+    slab.aabb.min = vec2_t(dataset.longitude.get(slab.from_idx[0]), dataset.latitude.get(slab.from_idx[1]));
+    slab.aabb.max = vec2_t(dataset.longitude.get(slab.to_idx[0] - 1), dataset.latitude.get(slab.to_idx[1] - 1));
+
+    return slab;
+}
+
+static std::mutex* libraryMutex() {
+#ifdef OMG_NETCDF_THREADSAFE
+    return nullptr;
+#else
+    // the netCDF and HDF5 libraries are not thread-safe by default, only one thread may call them
+    static std::mutex mutex;
+    return &mutex;
+#endif
+}
+
+static void readHyperslab(const Dataset& dataset, const Hyperslab& slab, int16_t* dst, std::size_t dst_stride,
+                          std::mutex* library_mutex = nullptr) {
+    // read the hyperslab into a destination grid with dst_stride values per row
+    // calls to the library are serialized if a mutex is given
+
+    auto lockLibrary = [library_mutex]() {
+        return library_mutex ? std::unique_lock(*library_mutex) : std::unique_lock<std::mutex>();
+    };
 
-    BathymetryData topo(real_aabb, grid_size);
+    const size2_t size = slab.size();
 
-    // read topography data
-    const std::vector<std::size_t> start = {from_idx[1], from_idx[0]};
-    const std::vector<std::size_t> count = {to_idx[1] - from_idx[1], to_idx[0] - from_idx[0]};
+    const std::vector<std::size_t> start = {slab.from_idx[1], slab.from_idx[0]};
+    const std::vector<std::size_t> count = {size[1], size[0]};
 
-    // buffer needed to convert from float to int16_t
-    std::vector<int16_t>& grid = topo.grid();
-    float* buffer = new float[grid.size()];
-    elevation.getVar(start, count, buffer);
+    if (!dataset.is_float) {
+        const auto lock = lockLibrary();
 
-    for (std::size_t i = 0; i < grid.size(); i++) {
-        grid[i] = static_cast<int16_t>(buffer[i]);
-        assert(static_cast<float>(grid[i]) == buffer[i]);
+        if (dst_stride == size[0]) {
+            dataset.elevation.getVar(start, count, dst);
+        } else {
+            // map the rows directly into the larger destination grid
+            const std::vector<std::ptrdiff_t> stride = {1, 1};
+            const std::vector<std::ptrdiff_t> imap = {static_cast<std::ptrdiff_t>(dst_stride), 1};
+            dataset.elevation.getVar(start, count, stride, imap, dst);
+        }
+        return;
     }
 
-    delete[] buffer;
+    // float values are read in row bands into a small buffer and converted to int16_t
+    const std::size_t band_rows = std::max<std::size_t>(CONVERSION_BUFFER_SIZE / size[0], 1);
+
+    thread_local std::vector<float> buffer;
+    buffer.resize(std::min(band_rows, size[1]) * size[0]);
+    const float* values = buffer.data();
+
+    for (std::size_t row = 0; row < size[1]; row += band_rows) {
+        const std::size_t rows = std::min(band_rows, size[1] - row);
+
+        {
+            const auto lock = lockLibrary();
+            dataset.elevation.getVar({start[0] + row, start[1]}, {rows, size[0]}, buffer.data());
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (std::size_t j = 0; j < rows; j++) {
+            const float* src = values + j * size[0];
+            int16_t* row_dst = dst + (row + j) * dst_stride;
 
-    return topo;
+            #pragma omp simd
+            for (std::size_t i = 0; i < size[0]; i++) {
+                row_dst[i] = static_cast<int16_t>(src[i]);
+            }
+        }
+    }
 }
 
+static std::vector<Hyperslab> splitIntoBands(const Dataset& dataset, const Hyperslab& slab, unsigned int num_threads) {
+    // row bands start at chunk boundaries of the file, so no chunk is decompressed twice
 
-static void concatBathymetry(BathymetryData& dst, const BathymetryData& low, const BathymetryData& high) {
-    const std::size_t low_stride = low.getGridSize()[0];
-    const std::size_t high_stride = high.getGridSize()[0];
+    std::size_t chunk_rows = 256;  // for contiguous data
+    std::size_t chunk_cols = slab.size()[0];
 
-    const std::size_t rows = dst.getGridSize()[1];
-    auto low_it = low.grid().begin();
-    auto high_it = high.grid().begin();
-    auto dst_it = dst.grid().begin();
+    netCDF::NcVar::ChunkMode mode = netCDF::NcVar::nc_CONTIGUOUS;
+    std::vector<std::size_t> chunk_sizes(2);
+    dataset.elevation.getChunkingParameters(mode, chunk_sizes);
 
-    for (std::size_t y = 0; y < rows; y++) {
-        dst_it = std::copy(low_it, low_it + low_stride, dst_it);
-        low_it += low_stride;
-        dst_it = std::copy(high_it, high_it + high_stride, dst_it);
-        high_it += high_stride;
+    if (mode == netCDF::NcVar::nc_CHUNKED && chunk_sizes.size() == 2 && chunk_sizes[0] > 0 && chunk_sizes[1] > 0) {
+        chunk_rows = chunk_sizes[0];
+        chunk_cols = chunk_sizes[1];
     }
+
+    // merge small chunks to about 4 bands per thread
+    const std::size_t rows = slab.size()[1];
+    const std::size_t target_bands = 4 * static_cast<std::size_t>(num_threads);
+    const std::size_t band_rows = chunk_rows * std::max<std::size_t>(rows / (chunk_rows * target_bands), 1);
+
+    if (mode == netCDF::NcVar::nc_CHUNKED) {
+        // the chunk cache has to hold one row of chunks of every band read at the same time
+        const std::size_t chunks_per_row = (slab.size()[0] + chunk_cols - 1) / chunk_cols + 1;
+        const std::size_t value_size = dataset.is_float ? sizeof(float) : sizeof(int16_t);
+        const std::size_t cache_chunks = chunks_per_row * (band_rows / chunk_rows + 1) * num_threads;
+        const std::size_t cache_size = std::min(cache_chunks * chunk_rows * chunk_cols * value_size, MAX_CHUNK_CACHE);
+
+        dataset.elevation.setChunkCache(cache_size, cache_chunks * 4 + 1, 1.0f);
+    }
+
+    std::vector<Hyperslab> bands;
+
+    std::size_t from = slab.from_idx[1];
+    while (from < slab.to_idx[1]) {
+        Hyperslab band = slab;
+        band.from_idx[1] = from;
+        band.to_idx[1] = std::min((from / band_rows + 1) * band_rows, slab.to_idx[1]);  // aligned end
+
+        bands.push_back(band);
+        from = band.to_idx[1];
+    }
+    return bands;
 }
 
+static void readHyperslabParallel(const Dataset& dataset, const Hyperslab& slab, int16_t* dst, std::size_t dst_stride,
+                                  unsigned int num_threads) {
+    // read row bands concurrently into their place in the destination grid
+
+    if (num_threads == 0) {
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads();
+#else
+        num_threads = 1;
+#endif
+    }
+
+    const std::vector<Hyperslab> bands = splitIntoBands(dataset, slab, num_threads);
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    for (std::size_t b = 0; b < bands.size(); b++) {
+        try {
+            int16_t* band_dst = dst + (bands[b].from_idx[1] - slab.from_idx[1]) * dst_stride;
+            readHyperslab(dataset, bands[b], band_dst, dst_stride, libraryMutex());
+
+        } catch (...) {
+            // exceptions must not leave the parallel region
+            const std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+static bool isGlobal(const Dataset& dataset, const Hyperslab& slab) {
+    // check if the longitude covers the complete circle
+    const std::size_t dim = dataset.longitude.var.getDim(0).getSize();
+    const size2_t size = slab.size();
+
+    if (slab.from_idx[0] != 0 || slab.to_idx[0] != dim) {
+        return false;
+    }
 
-BathymetryData readNetCDF(const std::string& filename) {
-    return readNetCDF(filename, EVERYTHING);
+    const real_t cell_size = (slab.aabb.max[0] - slab.aabb.min[0]) / (size[0] - 1);
+    return std::abs(cell_size * size[0] - (MAX_LON_COORD - MIN_LON_COORD)) < cell_size / 2;
 }
 
-BathymetryData readNetCDF(const std::string& filename, const AxisAlignedBoundingBox& aabb) {
+
+// reads tiles of the elevation grid on demand, the data cannot be modified
+class NetCDFTileSource : public TileSource<int16_t> {
+public:
+    NetCDFTileSource(const std::string& filename, const AxisAlignedBoundingBox& aabb)
+        : filename(filename), data_file(filename, netCDF::NcFile::read), dataset(openDataset(data_file, filename)),
+          slab(locateHyperslab(dataset, aabb)) {}
+
+    void readTile(const TileInfo& tile, int16_t* dst) override {
+        Hyperslab tile_slab;
+        tile_slab.from_idx = slab.from_idx + tile.origin;
+        tile_slab.to_idx = tile_slab.from_idx + tile.size;
+
+        try {
+            readHyperslab(dataset, tile_slab, dst, tile.size[0], libraryMutex());
+        } catch(netCDF::exceptions::NcException& e) {
+            throw std::runtime_error("Error reading data from " + filename + ": " + e.what());
+        }
+    }
+
+    void writeTile(const TileInfo&, const int16_t*) override {
+        throw std::runtime_error("NetCDF bathymetry tiles are read-only");
+    }
+
+    inline const Hyperslab& getHyperslab() const { return slab; }
+
+private:
+    const std::string filename;
+    const netCDF::NcFile data_file;
+
+    const Dataset dataset;
+    const Hyperslab slab;
+};
+
+std::unique_ptr<TiledBathymetryData> openNetCDFTiled(const std::string& filename, const AxisAlignedBoundingBox& aabb,
+                                                     std::size_t tile_size, std::size_t max_memory) {
+
+    if (aabb.min[0] < MIN_LON_COORD || aabb.max[0] > MAX_LON_COORD) {
+        throw std::runtime_error("Tiled access is only supported for longitudes in [-180, 180]");
+    }
+
+    try {
+        auto source = std::make_unique<NetCDFTileSource>(filename, aabb);
+        const Hyperslab slab = source->getHyperslab();
+
+        return std::make_unique<TiledBathymetryData>(slab.aabb, slab.size(), std::move(source), tile_size, max_memory);
+
+    } catch(netCDF::exceptions::NcException& e) {
+        throw std::runtime_error("Error reading data from " + filename + ": " + e.what());
+    }
+}
+
+CompressedBathymetryData readNetCDFCompressed(const std::string& filename) {
+    return readNetCDFCompressed(filename, EVERYTHING);
+}
+
+CompressedBathymetryData readNetCDFCompressed(const std::string& filename, const AxisAlignedBoundingBox& aabb) {
+
+    if (&aabb != &EVERYTHING && (aabb.min[0] < MIN_LON_COORD || aabb.max[0] > MAX_LON_COORD)) {
+        throw std::runtime_error("Compressed reading is only supported for longitudes in [-180, 180]");
+    }
+
     try {
-        // open netcdf file
         const netCDF::NcFile data_file(filename, netCDF::NcFile::read);
+        const Dataset dataset = openDataset(data_file, filename);
 
-        // check if the file is supported
-        const netCDF::NcGroupAtt attribute = data_file.getAtt("title");
-        if (attribute.isNull()) {
-            throw std::runtime_error("No title was found");
-        }
+        const Hyperslab slab = locateHyperslab(dataset, aabb);
+        const bool periodic = &aabb == &EVERYTHING && isGlobal(dataset, slab);
 
-        std::string title;
-        attribute.getValues(title);
+        auto read_rows = [&](std::size_t first_row, std::size_t num_rows, int16_t* dst) {
+            Hyperslab band = slab;
+            band.from_idx[1] = slab.from_idx[1] + first_row;
+            band.to_idx[1] = band.from_idx[1] + num_rows;
 
-        // select reader to use
-        std::function<BathymetryData(const netCDF::NcFile&, const AxisAlignedBoundingBox&)> reader;
-        if (startsWith(title, "The GEBCO_2020 Grid")) {
-            reader = readGEBCO20;
-        } else if (startsWith(title, "GEBCO_08 TOPOGRAPHY")) {
-            reader = readGEBCO08;
-        } else {
-            throw std::runtime_error("This file format is not supported");
-        }
+            readHyperslab(dataset, band, dst, slab.size()[0]);
+        };
+
+        return CompressedBathymetryData(slab.aabb, slab.size(), read_rows, periodic);
+
+    } catch(netCDF::exceptions::NcException& e) {
+        throw std::runtime_error("Error reading data from " + filename + ": " + e.what());
+    }
+}
+
+
+BathymetryData readNetCDF(const std::string& filename, unsigned int num_threads) {
+    return readNetCDF(filename, EVERYTHING, num_threads);
+}
+
+BathymetryData readNetCDF(const std::string& filename, const AxisAlignedBoundingBox& aabb, unsigned int num_threads) {
+    try {
+        // open netcdf file
+        const netCDF::NcFile data_file(filename, netCDF::NcFile::read);
+
+        // check if the file is supported
+        const Dataset dataset = openDataset(data_file, filename);
 
         // check if (-180, 180) or (0, 360) is used for lon
         if (&aabb == &EVERYTHING || aabb.max[0] < MAX_LON_COORD) {
-            return reader(data_file, aabb);
+            const Hyperslab slab = locateHyperslab(dataset, aabb);
+
+            // complete data wraps around at the antimeridian
+            const bool periodic = &aabb == &EVERYTHING && isGlobal(dataset, slab);
+
+            BathymetryData data(slab.aabb, slab.size(), periodic);
+            readHyperslabParallel(dataset, slab, data.grid().data(), slab.size()[0], num_threads);
+            return data;
         }
         if (aabb.min[0] > MAX_LON_COORD && aabb.max[0] > MAX_LON_COORD) {
             AxisAlignedBoundingBox mod_aabb = aabb;
             mod_aabb.min[0] = mod_aabb.min[0] - 2 * MAX_LON_COORD;
             mod_aabb.max[0] = mod_aabb.max[0] - 2 * MAX_LON_COORD;
 
-            BathymetryData mod_data = reader(data_file, mod_aabb);
-            mod_aabb = mod_data.getBoundingBox();
+            const Hyperslab slab = locateHyperslab(dataset, mod_aabb);
+
+            // shift coordinates back, the data is read directly into the result
+            mod_aabb = slab.aabb;
             mod_aabb.min[0] = mod_aabb.min[0] + 2 * MAX_LON_COORD;
             mod_aabb.max[0] = mod_aabb.max[0] + 2 * MAX_LON_COORD;
 
-            BathymetryData data(mod_aabb, mod_data.getGridSize());
-            data.grid() = std::move(mod_data.grid());
+            BathymetryData data(mod_aabb, slab.size());
+            readHyperslabParallel(dataset, slab, data.grid().data(), slab.size()[0], num_threads);
             return data;
         }
         if (aabb.min[0] < MAX_LON_COORD && aabb.max[0] > MAX_LON_COORD) {
             AxisAlignedBoundingBox mod_aabb = aabb;
             mod_aabb.max[0] = MAX_LON_COORD;
-            const BathymetryData low_data = reader(data_file, mod_aabb);
+            const Hyperslab low_slab = locateHyperslab(dataset, mod_aabb);
 
             mod_aabb = aabb;
             mod_aabb.min[0] = MIN_LON_COORD;
             mod_aabb.max[0] = mod_aabb.max[0] - 2 * MAX_LON_COORD;
-            const BathymetryData high_data = reader(data_file, mod_aabb);
+            const Hyperslab high_slab = locateHyperslab(dataset, mod_aabb);
 
-            const size2_t grid_size(low_data.getGridSize()[0] + high_data.getGridSize()[0], low_data.getGridSize()[1]);
-            mod_aabb = low_data.getBoundingBox();
-            mod_aabb.max[0] = high_data.getBoundingBox().max[0] + 2 * MAX_LON_COORD;
+            const size2_t grid_size(low_slab.size()[0] + high_slab.size()[0], low_slab.size()[1]);
+            mod_aabb = low_slab.aabb;
+            mod_aabb.max[0] = high_slab.aabb.max[0] + 2 * MAX_LON_COORD;
 
+            // read both sides of the antimeridian directly into their columns of the result
             BathymetryData data(mod_aabb, grid_size);
-            concatBathymetry(data, low_data, high_data);
+            readHyperslabParallel(dataset, low_slab, data.grid().data(), grid_size[0], num_threads);
+            readHyperslabParallel(dataset, high_slab, data.grid().data() + low_slab.size()[0], grid_size[0], num_threads);
             return data;
         }
         throw std::runtime_error("Invalid bounding box");
@@ -374,6 +601,27 @@ BathymetryData readNetCDF(const std::string& filename, const AxisAlignedBounding
     }
 }
 
+BathymetryData readNetCDFCached(const std::string& filename, const AxisAlignedBoundingBox& aabb,
+                                const std::string& cache_file, unsigned int num_threads) {
+
+    const uint64_t checksum = sourceChecksum(filename, aabb);
+
+    if (isValidBathymetryGridFile(cache_file, checksum)) {
+        return readBathymetryGridFile(cache_file);
+    }
+
+    BathymetryData data = readNetCDF(filename, aabb, num_threads);
+
+    // a missing cache only costs time
+    try {
+        writeGridFile(cache_file, data, checksum);
+    } catch (const std::exception& e) {
+        std::cerr << "warning: could not write bathymetry cache: " << e.what() << std::endl;
+    }
+
+    return data;
+}
+
 }
 }
 
@@ -1,13 +1,34 @@
 #pragma once
 
+#include <memory>
+
+#include <topology/compressed_scalar_field.h>
 #include <topology/scalar_field.h>
+#include <topology/tiled_scalar_field.h>
 
 namespace omg {
 namespace io {
 
-BathymetryData readNetCDF(const std::string& filename, const AxisAlignedBoundingBox& aabb);
+// the grid is read in row bands aligned to the chunks of the file, num_threads = 0 uses all OpenMP threads
+BathymetryData readNetCDF(const std::string& filename, const AxisAlignedBoundingBox& aabb, unsigned int num_threads = 0);
+
+BathymetryData readNetCDF(const std::string& filename, unsigned int num_threads = 0);
+
+// use the crop stored in cache_file if it was created from the same file and bounding box,
+// otherwise read the NetCDF file and write the cache
+BathymetryData readNetCDFCached(const std::string& filename, const AxisAlignedBoundingBox& aabb,
+                                const std::string& cache_file, unsigned int num_threads = 0);
+
+// open the bathymetry without reading it, tiles are read on demand and the memory of loaded tiles
+// is limited by max_memory in bytes
+std::unique_ptr<TiledBathymetryData> openNetCDFTiled(const std::string& filename, const AxisAlignedBoundingBox& aabb,
+                                                     std::size_t tile_size = 256,
+                                                     std::size_t max_memory = std::size_t(256) << 20);
+
+// read the bathymetry in row bands and compress it, the uncompressed grid is never kept in memory
+CompressedBathymetryData readNetCDFCompressed(const std::string& filename, const AxisAlignedBoundingBox& aabb);
 
-BathymetryData readNetCDF(const std::string& filename);
+CompressedBathymetryData readNetCDFCompressed(const std::string& filename);
 
 }
 }
@@ -1,14 +1,102 @@
 
-#include <filesystem>
+#include <algorithm>
+#include <charconv>
+#include <exception>
 #include <fstream>
-#include <unordered_map>
+#include <future>
+#include <mutex>
+#include <vector>
 
 #include "nod2d_writer.h"
 
+#include <topology/compressed_scalar_field.h>
+#include <topology/tiled_scalar_field.h>
+
 namespace omg {
 namespace io {
 
-void writeNod2D(const Mesh& mesh, const BathymetryData& topo, const std::string& name, bool zero_based) {
+// upper bounds for the formatted output, a line has at most 3 numbers
+static const std::size_t MAX_NUMBER_LENGTH = 32;
+static const std::size_t MAX_LINE_LENGTH = 4 * MAX_NUMBER_LENGTH;
+
+static const std::size_t MIN_BLOCK_LINES = std::size_t(1) << 14;
+static const std::size_t MAX_BLOCKS = 256;
+
+template<typename T>
+static inline char* writeNumber(char* p, T value) {
+    return std::to_chars(p, p + MAX_NUMBER_LENGTH, value).ptr;
+}
+
+// same output as std::setprecision(15)
+static inline char* writeNumber(char* p, real_t value) {
+    return std::to_chars(p, p + MAX_NUMBER_LENGTH, value, std::chars_format::general, 15).ptr;
+}
+
+// formatted file content, the first block is the header
+using Blocks = std::vector<std::string>;
+
+// format the lines [0, num_lines) in parallel with f(index, buffer) -> end of the line
+// every block is formatted by one thread into its own buffer, the blocks are kept in order
+// with_count writes the number of lines as header, nodhn.out has none
+template<typename Function>
+static Blocks formatLines(std::size_t num_lines, bool with_count, Function f) {
+    const std::size_t num_blocks = std::clamp<std::size_t>(num_lines / MIN_BLOCK_LINES, 1, MAX_BLOCKS);
+
+    Blocks blocks(num_blocks + 1);
+    if (with_count) {
+        blocks[0] = std::to_string(num_lines) + "\n";
+    }
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (std::size_t b = 0; b < num_blocks; b++) {
+        try {
+            const std::size_t begin = num_lines * b / num_blocks;
+            const std::size_t end = num_lines * (b + 1) / num_blocks;
+
+            std::string& buffer = blocks[b + 1];
+            buffer.resize((end - begin) * MAX_LINE_LENGTH);
+
+            char* p = buffer.data();
+            for (std::size_t i = begin; i < end; i++) {
+                p = f(i, p);
+            }
+            buffer.resize(p - buffer.data());
+
+        } catch (...) {
+            // exceptions must not leave the parallel region, e.g. a vertex outside of the bathymetry
+            const std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return blocks;
+}
+
+static void writeBlocks(const std::string& filename, const Blocks& blocks) {
+    std::ofstream file(filename);
+
+    for (const std::string& block : blocks) {
+        file.write(block.data(), block.size());
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+}
+
+// point(i) -> vec2_t and triangle(i) -> FlatMesh::Triangle
+template<typename PointAccess, typename TriangleAccess, typename Bathymetry>
+static void writeNod2D(std::size_t num_vertices, PointAccess point, std::size_t num_triangles, TriangleAccess triangle,
+                       const Bathymetry& topo, const std::string& name, bool zero_based) {
 
     std::string elem2d_filename, nod2d_filename, nodhn_filename;
     if (!name.empty()) {
@@ -20,52 +108,94 @@ void writeNod2D(const Mesh& mesh, const BathymetryData& topo, const std::string&
     nod2d_filename += "nod2d.out";
     nodhn_filename += "nodhn.out";
 
-    std::size_t counter = zero_based ? 0 : 1;
-    std::unordered_map<std::size_t, std::size_t> vertex_table;  // index translation table
+    // indices are dense, they only need an offset
+    const std::size_t offset = zero_based ? 0 : 1;
 
     // write vertices and heights
-    std::ofstream nod2d_file(nod2d_filename);
-    std::ofstream nodhn_file(nodhn_filename);
+    const Blocks nod2d = formatLines(num_vertices, true, [&](std::size_t i, char* p) {
+        const vec2_t pos = point(i);
+
+        p = writeNumber(p, i + offset);
+        *p++ = ' ';
+        p = writeNumber(p, pos[0]);
+        *p++ = ' ';
+        p = writeNumber(p, pos[1]);
+        *p++ = ' ';
+        *p++ = '0';  // TODO: fix boundary marker
+        *p++ = '\n';
+        return p;
+    });
+
+    const Blocks nodhn = formatLines(num_vertices, false, [&](std::size_t i, char* p) {
+        p = writeNumber(p, topo.template getValue<real_t>(point(i)));
+        *p++ = '\n';
+        return p;
+    });
+
+    // the files are written while the triangles are formatted
+    std::future<void> nod2d_written = std::async(std::launch::async, writeBlocks, nod2d_filename, std::cref(nod2d));
+    std::future<void> nodhn_written = std::async(std::launch::async, writeBlocks, nodhn_filename, std::cref(nodhn));
 
-    nod2d_file << std::setprecision(15);
-    nodhn_file << std::setprecision(15);
+    // write triangles
+    const Blocks elem2d = formatLines(num_triangles, true, [&](std::size_t i, char* p) {
+        const FlatMesh::Triangle t = triangle(i);
+
+        p = writeNumber(p, t[0] + offset);
+        *p++ = ' ';
+        p = writeNumber(p, t[1] + offset);
+        *p++ = ' ';
+        p = writeNumber(p, t[2] + offset);
+        *p++ = '\n';
+        return p;
+    });
+
+    writeBlocks(elem2d_filename, elem2d);
+
+    nod2d_written.get();
+    nodhn_written.get();
+}
 
-    nod2d_file << mesh.n_vertices() << "\n";
+template<typename Bathymetry>
+void writeNod2D(const Mesh& mesh, const Bathymetry& topo, const std::string& name, bool zero_based) {
 
-    for (auto vh : mesh.vertices()) {
+    const auto point = [&](std::size_t i) {
+        return toVec2(mesh.point(OpenMesh::VertexHandle(static_cast<int>(i))));
+    };
 
-        vertex_table[vh.idx()] = counter;
+    const auto triangle = [&](std::size_t i) {
+        FlatMesh::Triangle t;
+        std::size_t corner = 0;
+        for (const auto& vh : mesh.fv_range(OpenMesh::FaceHandle(static_cast<int>(i)))) {
+            t[corner++] = vh.idx();
+        }
+        return t;
+    };
 
-        const vec3_t& point = mesh.point(vh);
-        nod2d_file << counter << " " << point[0] << " " << point[1] << " 0\n";  // TODO: fix boundary marker
+    writeNod2D(mesh.n_vertices(), point, mesh.n_faces(), triangle, topo, name, zero_based);
+}
 
-        nodhn_file << topo.getValue<real_t>(toVec2(point)) << "\n";
+template<typename Bathymetry>
+void writeNod2D(const FlatMesh& mesh, const Bathymetry& topo, const std::string& name, bool zero_based) {
 
-        counter++;
-    }
-    nod2d_file.close();
-    nodhn_file.close();
+    const auto point = [&](std::size_t i) {
+        return mesh.getPoint(i);
+    };
 
-    // write triangles
-    std::ofstream elem2d_file(elem2d_filename);
+    const auto triangle = [&](std::size_t i) {
+        return mesh.getTriangle(i);
+    };
 
-    elem2d_file << mesh.n_faces() << "\n";
+    writeNod2D(mesh.numVertices(), point, mesh.numTriangles(), triangle, topo, name, zero_based);
+}
 
-    for (auto fh : mesh.faces()) {
+template void writeNod2D(const Mesh&, const BathymetryData&, const std::string&, bool);
+template void writeNod2D(const FlatMesh&, const BathymetryData&, const std::string&, bool);
 
-        bool first = true;
-        for (auto vh : fh.vertices()) {
-            if (!first) {
-                elem2d_file << " ";
-            }
-            elem2d_file << vertex_table[vh.idx()];
-            first = false;
-        }
+template void writeNod2D(const Mesh&, const TiledBathymetryData&, const std::string&, bool);
+template void writeNod2D(const FlatMesh&, const TiledBathymetryData&, const std::string&, bool);
 
-        elem2d_file << "\n";
-    }
-    elem2d_file.close();
-}
+template void writeNod2D(const Mesh&, const CompressedBathymetryData&, const std::string&, bool);
+template void writeNod2D(const FlatMesh&, const CompressedBathymetryData&, const std::string&, bool);
 
 }
 }
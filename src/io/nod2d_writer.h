@@ -2,13 +2,19 @@
 
 #include <string>
 
+#include <mesh/flat_mesh.h>
 #include <mesh/mesh.h>
 #include <topology/scalar_field.h>
 
 namespace omg {
 namespace io {
 
-void writeNod2D(const Mesh& mesh, const BathymetryData& topo, const std::string& name = "", bool zero_based = false);
+// instantiated for BathymetryData, TiledBathymetryData and CompressedBathymetryData
+template<typename Bathymetry>
+void writeNod2D(const Mesh& mesh, const Bathymetry& topo, const std::string& name = "", bool zero_based = false);
+
+template<typename Bathymetry>
+void writeNod2D(const FlatMesh& mesh, const Bathymetry& topo, const std::string& name = "", bool zero_based = false);
 
 }
 }
@@ -2,23 +2,49 @@
 #include <OpenMesh/Core/IO/MeshIO.hh>
 
 #include <filesystem>
+#include <fstream>
 
 #include "off_writer.h"
 
 namespace omg {
 namespace io {
 
-void writeOff(const std::string& filename, const Mesh& mesh) {
+static void checkExtension(const std::string& filename) {
     const std::filesystem::path filepath(filename);
 
     if (filepath.extension() != ".off") {  // TODO: useless restriction, but for now ...
         throw std::runtime_error("Wrong file format: " + filename + " expected: .off");
     }
+}
+
+void writeOff(const std::string& filename, const Mesh& mesh) {
+    checkExtension(filename);
 
     if (!OpenMesh::IO::write_mesh(mesh, filename)) {
         throw std::runtime_error("Error writing file: " + filename);
     }
 }
 
+void writeOff(const std::string& filename, const FlatMesh& mesh) {
+    checkExtension(filename);
+
+    // same layout and precision as the OpenMesh writer
+    std::ofstream file(filename);
+
+    file << "OFF\n";
+    file << mesh.numVertices() << " " << mesh.numTriangles() << " 0\n";
+
+    for (const vec2_t& p : mesh.getPoints()) {
+        file << p[0] << " " << p[1] << " 0\n";
+    }
+    for (const FlatMesh::Triangle& t : mesh.getTriangles()) {
+        file << "3 " << t[0] << " " << t[1] << " " << t[2] << "\n";
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing file: " + filename);
+    }
+}
+
 }
 }
@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include <mesh/flat_mesh.h>
 #include <mesh/mesh.h>
 
 namespace omg {
@@ -9,5 +10,7 @@ namespace io {
 
 void writeOff(const std::string& filename, const Mesh& mesh);  // TODO: improve IO system
 
+void writeOff(const std::string& filename, const FlatMesh& mesh);
+
 }
 }
@@ -1,55 +1,184 @@
 #include "poly_reader.h"
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
 #include <filesystem>
+#include <numeric>
 
-#include <OpenMesh/Core/Geometry/VectorT.hh>
+#include <io/mapped_file.h>
 
 namespace omg {
 namespace io {
 
-struct VertexBuffer {
-    std::vector<vec2_t> vertices;
-    bool zero_based;
+static const std::size_t MIN_CHUNK_SIZE = std::size_t(1) << 16;
+static const std::size_t MAX_CHUNKS = 256;
+
+static inline const char* skipSpaces(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// call f(begin, end) for every line with data, empty lines and comments are skipped
+// stops if f returns false
+template<typename Function>
+static void scanLines(const char* begin, const char* end, Function f) {
+    const char* p = begin;
+
+    while (p != end) {
+        const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!line_end) {
+            line_end = end;
+        }
+
+        const char* content = skipSpaces(p, line_end);
+        if (content != line_end && *content != '#') {
+            if (!f(content, line_end)) {
+                return;
+            }
+        }
+
+        p = line_end == end ? end : line_end + 1;
+    }
+}
+
+// text split into chunks at line boundaries, knows the index of the first data line of every chunk
+struct TextChunks {
+    TextChunks(const char* begin, const char* end) {
+        const std::size_t size = end - begin;
+        const std::size_t num_chunks = std::clamp<std::size_t>(size / MIN_CHUNK_SIZE, 1, MAX_CHUNKS);
+
+        bounds.push_back(begin);
+        for (std::size_t c = 1; c < num_chunks; c++) {
+            const char* p = std::max(begin + size * c / num_chunks, bounds.back());
+
+            // move to the start of the next line
+            const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            bounds.push_back(line_end ? line_end + 1 : end);
+        }
+        bounds.push_back(end);
+
+        // count data lines per chunk
+        first_line.assign(bounds.size(), 0);
+
+        #pragma omp parallel for schedule(dynamic)
+        for (std::size_t c = 0; c < num_chunks; c++) {
+            std::size_t count = 0;
+            scanLines(bounds[c], bounds[c + 1], [&count](const char*, const char*) { count++; return true; });
+            first_line[c + 1] = count;
+        }
+
+        std::partial_sum(first_line.begin(), first_line.end(), first_line.begin());
+    }
+
+    inline std::size_t numChunks() const { return bounds.size() - 1; }
+    inline std::size_t numLines() const { return first_line.back(); }
+
+    std::vector<const char*> bounds;
+    std::vector<std::size_t> first_line;
 };
 
-static void ignoreComments(std::ifstream& file) {
-    // read until a line without comment is found
-    int c = file.peek();
-    while (c != EOF && static_cast<char>(c) == '#') {
-        std::string ignore;
-        std::getline(file, ignore);
-        c = file.peek();
+template<typename T>
+static bool parseNumber(const char*& p, const char* end, T& value) {
+    p = skipSpaces(p, end);
+    if (p != end && *p == '+') {
+        p++;  // not accepted by from_chars
     }
+
+    const std::from_chars_result result = std::from_chars(p, end, value);
+    p = result.ptr;
+
+    return result.ec == std::errc();
 }
 
-static void readVertex(std::ifstream& file, std::size_t& idx_out, vec2_t& v_out) {
-    ignoreComments(file);
-    std::string ignore;
-    file >> idx_out >> v_out[0] >> v_out[1];  // read idx, x, y
-    std::getline(file, ignore);  // ignore rest of line
+static void checkLines(const TextChunks& text, std::size_t last, const std::string& filename) {
+    if (last > text.numLines()) {
+        throw std::runtime_error("Unexpected end of file: " + filename);
+    }
 }
 
-static void readVertices(std::ifstream& file, VertexBuffer& vb, std::size_t num_vertices) {
-    if (num_vertices == 0) {
-        return;
+// first number of a data line
+static std::size_t readCount(const TextChunks& text, std::size_t line, const std::string& filename) {
+    checkLines(text, line + 1, filename);
+
+    // only the chunk containing the line is searched
+    const std::size_t c = std::upper_bound(text.first_line.begin(), text.first_line.end(), line)
+                          - text.first_line.begin() - 1;
+
+    std::size_t count = 0;
+    bool valid = false;
+    std::size_t current = text.first_line[c];
+
+    scanLines(text.bounds[c], text.bounds[c + 1], [&](const char* begin, const char* end) {
+        if (current++ != line) {
+            return true;
+        }
+        valid = parseNumber(begin, end, count);
+        return false;
+    });
+
+    if (!valid) {
+        throw std::runtime_error("Error parsing file: " + filename);
+    }
+    return count;
+}
+
+// parse the data lines [first, first + count) in parallel with f(local_index, begin, end)
+template<typename Function>
+static void parseLines(const TextChunks& text, std::size_t first, std::size_t count, const std::string& filename,
+                       Function f) {
+
+    checkLines(text, first + count, filename);
+
+    std::atomic<bool> failed(false);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (std::size_t c = 0; c < text.numChunks(); c++) {
+
+        // skip chunks outside the range
+        if (text.first_line[c + 1] <= first || text.first_line[c] >= first + count) {
+            continue;
+        }
+
+        std::size_t line = text.first_line[c];
+
+        scanLines(text.bounds[c], text.bounds[c + 1], [&](const char* begin, const char* end) {
+            if (line >= first && line < first + count && !f(line - first, begin, end)) {
+                failed = true;
+                return false;
+            }
+            line++;
+            return line < first + count;
+        });
     }
 
-    vb.vertices.reserve(num_vertices);
+    if (failed) {
+        throw std::runtime_error("Error parsing file: " + filename);
+    }
+}
 
-    std::size_t idx;
-    vec2_t vertex(0);
+static void readVertices(const TextChunks& text, std::vector<vec2_t>& vertices, bool& zero_based,
+                         const std::string& filename) {
 
-    // read first vertex and check if indices are zero based
-    readVertex(file, idx, vertex);
-    vb.vertices.push_back(vertex);
-    vb.zero_based = (idx == 0);
+    // vertices info: num_vertices, dimension, num_attributes, num_boundary_markers
+    const std::size_t num_vertices = readCount(text, 0, filename);
+    vertices.resize(num_vertices);
 
-    // read rest of vertices
-    for (std::size_t i = 1; i < num_vertices; i++) {
-        readVertex(file, idx, vertex);
-        vb.vertices.push_back(vertex);
+    if (num_vertices == 0) {
+        return;
     }
+
+    // check if indices are zero based
+    zero_based = readCount(text, 1, filename) == 0;
+
+    parseLines(text, 1, num_vertices, filename, [&](std::size_t i, const char* begin, const char* end) {
+        std::size_t idx;
+        return parseNumber(begin, end, idx) && parseNumber(begin, end, vertices[i][0]) &&
+               parseNumber(begin, end, vertices[i][1]);
+    });
 }
 
 LineGraph readPoly(const std::string& filename) {
@@ -60,75 +189,54 @@ LineGraph readPoly(const std::string& filename) {
         throw std::runtime_error("Wrong file format: " + filename + " expected: .poly");
     }
 
-    LineGraph poly;
-
-    // open file
-    std::ifstream file(filename);
-    if (!file.good()) {
-        throw std::runtime_error("Error reading file: " + filename);
-    }
+    const MappedFile file(filename);
+    const TextChunks text(file.data(), file.data() + file.size());
 
-    ignoreComments(file);
-    // read vertices info
-    std::size_t num_vertices;
-    int dimension, num_attributes, num_boundary_markers;
-    file >> num_vertices >> dimension >> num_attributes >> num_boundary_markers;
+    std::vector<vec2_t> vertices;
+    bool zero_based = true;
 
     // read vertices from this .poly file or a .node file with the same name
-    VertexBuffer v_buf;
-    if (num_vertices == 0) {
+    std::size_t segments_line;
+    if (readCount(text, 0, filename) == 0) {
 
         // create path of .node file
         std::filesystem::path node_path = file_path;
         node_path.replace_extension(".node");
 
-        std::ifstream node_file(node_path);
-        if (!node_file.good()) {
-            throw std::runtime_error("Error reading file: " + node_path.string());
-        }
-
-        ignoreComments(node_file);
-        // override vertices info
-        node_file >> num_vertices >> dimension >> num_attributes >> num_boundary_markers;
+        const MappedFile node_file(node_path.string());
+        const TextChunks node_text(node_file.data(), node_file.data() + node_file.size());
 
-        readVertices(node_file, v_buf, num_vertices);
-
-        node_file.close();
+        readVertices(node_text, vertices, zero_based, node_path.string());
+        segments_line = 1;
     } else {
-        readVertices(file, v_buf, num_vertices);
-    }
-
-    for (const vec2_t& v : v_buf.vertices) {
-        poly.addVertex(v);
+        readVertices(text, vertices, zero_based, filename);
+        segments_line = vertices.size() + 1;
     }
 
-    ignoreComments(file);
-    // read segments info
-    std::size_t num_segments;
-    file >> num_segments >> num_boundary_markers;
+    // segments info: num_segments, num_boundary_markers
+    const std::size_t num_segments = readCount(text, segments_line, filename);
+    std::vector<LineGraph::Edge> edges(num_segments);
 
-    // read segments
-    std::string ignore;
-    LineGraph::VertexHandle start_vertex, end_vertex;
+    parseLines(text, segments_line + 1, num_segments, filename, [&](std::size_t i, const char* begin, const char* end) {
+        std::size_t idx;
+        return parseNumber(begin, end, idx) && parseNumber(begin, end, edges[i].first) &&
+               parseNumber(begin, end, edges[i].second);
+    });
 
-    for (std::size_t i = 0; i < num_segments; i++) {
-
-        ignoreComments(file);
-        file >> ignore >> start_vertex >> end_vertex;
-        std::getline(file, ignore);
+    // TODO: handle holes
 
-        // adjust vertex indices to be zero based
-        if (!v_buf.zero_based) {
-            start_vertex -= 1;
-            end_vertex -= 1;
-        }
+    LineGraph poly;
+    poly.reserve(vertices.size(), edges.size());
 
-        poly.addEdge(start_vertex, end_vertex);
+    for (const vec2_t& v : vertices) {
+        poly.addVertex(v);
     }
 
-    // TODO: handle holes
-
-    file.close();
+    // adjust vertex indices to be zero based
+    const std::size_t offset = zero_based ? 0 : 1;
+    for (const LineGraph::Edge& e : edges) {
+        poly.addEdge(e.first - offset, e.second - offset);
+    }
 
     return poly;
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+
+#include <topology/tiled_scalar_field.h>
+
+namespace omg {
+namespace io {
+
+// raw local tile storage for TiledScalarField, every tile occupies tile_size * tile_size values
+// in native byte order, tiles at the upper borders are padded
+template<typename T>
+class TileFile : public TileSource<T> {
+public:
+    // create a new file filled with zeros or open an existing one
+    TileFile(const std::string& filename, const size2_t& grid_size, std::size_t tile_size, bool create);
+
+    void readTile(const TileInfo& tile, T* dst) override;
+    void writeTile(const TileInfo& tile, const T* src) override;
+
+private:
+    const std::string filename;
+    const std::size_t tile_size;
+    const size2_t tile_count;
+
+    std::mutex mutex;
+    std::fstream file;
+    std::vector<T> buffer;
+
+    std::streamoff offset(const TileInfo& tile) const;
+};
+
+
+// ---------------------- implementation ----------------------
+
+template<typename T>
+TileFile<T>::TileFile(const std::string& filename, const size2_t& grid_size, std::size_t tile_size, bool create)
+    : filename(filename), tile_size(tile_size), tile_count((grid_size + size2_t(tile_size - 1)) / tile_size),
+      buffer(tile_size * tile_size) {
+
+    const std::size_t file_size = tile_count[0] * tile_count[1] * buffer.size() * sizeof(T);
+
+    if (create) {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        if (!out.good()) {
+            throw std::runtime_error("Error writing to file: " + filename);
+        }
+
+        // allocate file with zeros
+        const std::vector<T> zeros(buffer.size(), T(0));
+        for (std::size_t i = 0; i < tile_count[0] * tile_count[1]; i++) {
+            out.write(reinterpret_cast<const char*>(zeros.data()), zeros.size() * sizeof(T));
+        }
+    }
+
+    file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.good()) {
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+
+    file.seekg(0, std::ios::end);
+    if (static_cast<std::size_t>(file.tellg()) != file_size) {
+        throw std::runtime_error("Tile file has the wrong size: " + filename);
+    }
+}
+
+template<typename T>
+void TileFile<T>::readTile(const TileInfo& tile, T* dst) {
+    const std::lock_guard lock(mutex);
+
+    file.seekg(offset(tile));
+    file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(T));
+
+    if (!file.good()) {
+        throw std::runtime_error("Error reading file: " + filename);
+    }
+
+    // remove padding
+    for (std::size_t j = 0; j < tile.size[1]; j++) {
+        std::copy_n(buffer.begin() + j * tile_size, tile.size[0], dst + j * tile.size[0]);
+    }
+}
+
+template<typename T>
+void TileFile<T>::writeTile(const TileInfo& tile, const T* src) {
+    const std::lock_guard lock(mutex);
+
+    // add padding
+    for (std::size_t j = 0; j < tile.size[1]; j++) {
+        std::copy_n(src + j * tile.size[0], tile.size[0], buffer.begin() + j * tile_size);
+    }
+
+    file.seekp(offset(tile));
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(T));
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+}
+
+template<typename T>
+std::streamoff TileFile<T>::offset(const TileInfo& tile) const {
+    const std::size_t linear = tile.index[0] + tile.index[1] * tile_count[0];
+    return static_cast<std::streamoff>(linear * buffer.size() * sizeof(T));
+}
+
+}
+}
@@ -0,0 +1,200 @@
+
+#ifdef OMG_REQUIRE_NETCDF
+
+#include "ugrid_writer.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <netcdf>
+
+#include <topology/compressed_scalar_field.h>
+#include <topology/tiled_scalar_field.h>
+
+namespace omg {
+namespace io {
+
+static const std::size_t CHUNK_SIZE = std::size_t(1) << 16;  // elements along the node and face dimensions
+static const std::size_t FACE_SIZE = 3;
+
+static void setStorage(const netCDF::NcVar& var, std::vector<std::size_t> chunks, int deflate_level) {
+    // netCDF does not allow chunks larger than a fixed dimension
+    if (std::find(chunks.begin(), chunks.end(), 0) != chunks.end()) {
+        return;
+    }
+    var.setChunking(netCDF::NcVar::nc_CHUNKED, chunks);
+
+    if (deflate_level > 0) {
+        var.setCompression(true, true, deflate_level);
+    }
+}
+
+static netCDF::NcVar addNodeVar(const netCDF::NcFile& file, const std::string& name, const netCDF::NcDim& dim,
+                                const std::string& long_name, const std::string& units, int deflate_level) {
+
+    const netCDF::NcVar var = file.addVar(name, netCDF::ncDouble, dim);
+    setStorage(var, {std::min(dim.getSize(), CHUNK_SIZE)}, deflate_level);
+
+    var.putAtt("long_name", long_name);
+    var.putAtt("units", units);
+    return var;
+}
+
+// node coordinates, bathymetry and face nodes gathered from the mesh
+struct UGRIDArrays {
+    std::vector<double> node_x;
+    std::vector<double> node_y;
+    std::vector<double> node_depth;
+    std::vector<int> face_nodes;
+};
+
+static void writeUGRID(const std::string& filename, const UGRIDArrays& arrays, int deflate_level) {
+
+    const std::size_t num_nodes = arrays.node_x.size();
+    const std::size_t num_faces = arrays.face_nodes.size() / FACE_SIZE;
+
+    netCDF::NcFile file(filename, netCDF::NcFile::replace, netCDF::NcFile::nc4);
+
+    file.putAtt("Conventions", "CF-1.8 UGRID-1.0");
+
+    const netCDF::NcDim node_dim = file.addDim("nMesh2_node", num_nodes);
+    const netCDF::NcDim face_dim = file.addDim("nMesh2_face", num_faces);
+    const netCDF::NcDim face_size_dim = file.addDim("nMaxMesh2_face_nodes", FACE_SIZE);
+
+    // dummy variable describing the topology
+    const netCDF::NcVar mesh_var = file.addVar("Mesh2", netCDF::ncInt);
+    mesh_var.putAtt("cf_role", "mesh_topology");
+    mesh_var.putAtt("long_name", "Topology data of 2D unstructured mesh");
+    mesh_var.putAtt("topology_dimension", netCDF::ncInt, 2);
+    mesh_var.putAtt("node_coordinates", "Mesh2_node_x Mesh2_node_y");
+    mesh_var.putAtt("face_node_connectivity", "Mesh2_face_nodes");
+    mesh_var.putAtt("face_dimension", "nMesh2_face");
+
+    const netCDF::NcVar x_var = addNodeVar(file, "Mesh2_node_x", node_dim, "Longitude of 2D mesh nodes",
+                                           "degrees_east", deflate_level);
+    x_var.putAtt("standard_name", "longitude");
+
+    const netCDF::NcVar y_var = addNodeVar(file, "Mesh2_node_y", node_dim, "Latitude of 2D mesh nodes",
+                                           "degrees_north", deflate_level);
+    y_var.putAtt("standard_name", "latitude");
+
+    // elevation like the input bathymetry, negative below sea level
+    const netCDF::NcVar depth_var = addNodeVar(file, "Mesh2_depth", node_dim, "Bathymetry at the mesh nodes", "m",
+                                               deflate_level);
+    depth_var.putAtt("positive", "up");
+    depth_var.putAtt("mesh", "Mesh2");
+    depth_var.putAtt("location", "node");
+    depth_var.putAtt("coordinates", "Mesh2_node_x Mesh2_node_y");
+
+    const netCDF::NcVar faces_var = file.addVar("Mesh2_face_nodes", netCDF::ncInt, {face_dim, face_size_dim});
+    setStorage(faces_var, {std::min(num_faces, CHUNK_SIZE), FACE_SIZE}, deflate_level);
+    faces_var.putAtt("cf_role", "face_node_connectivity");
+    faces_var.putAtt("long_name", "Maps every triangular face to its three corner nodes");
+    faces_var.putAtt("start_index", netCDF::ncInt, 0);
+
+    x_var.putVar(arrays.node_x.data());
+    y_var.putVar(arrays.node_y.data());
+    depth_var.putVar(arrays.node_depth.data());
+    faces_var.putVar(arrays.face_nodes.data());
+}
+
+// point(i) -> vec2_t and triangle(i) -> FlatMesh::Triangle
+template<typename PointAccess, typename TriangleAccess, typename Bathymetry>
+static UGRIDArrays gatherArrays(std::size_t num_nodes, PointAccess point, std::size_t num_faces, TriangleAccess triangle,
+                                const Bathymetry& topo) {
+
+    if (num_nodes > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("Too many vertices for UGRID output: " + std::to_string(num_nodes));
+    }
+
+    // gather the data in parallel, the netCDF library is only called from one thread
+    UGRIDArrays arrays;
+    arrays.node_x.resize(num_nodes);
+    arrays.node_y.resize(num_nodes);
+    arrays.node_depth.resize(num_nodes);
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < num_nodes; i++) {
+        try {
+            const vec2_t p = point(i);
+
+            arrays.node_x[i] = p[0];
+            arrays.node_y[i] = p[1];
+            arrays.node_depth[i] = topo.template getValue<real_t>(p);
+
+        } catch (...) {
+            // exceptions must not leave the parallel region, e.g. a vertex outside of the bathymetry
+            const std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    arrays.face_nodes.resize(num_faces * FACE_SIZE);
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < num_faces; i++) {
+        const FlatMesh::Triangle t = triangle(i);
+        std::copy(t.begin(), t.end(), arrays.face_nodes.begin() + i * FACE_SIZE);
+    }
+
+    return arrays;
+}
+
+template<typename Bathymetry>
+void writeUGRID(const std::string& filename, const Mesh& mesh, const Bathymetry& topo, int deflate_level) {
+
+    const auto point = [&](std::size_t i) {
+        return toVec2(mesh.point(OpenMesh::VertexHandle(static_cast<int>(i))));
+    };
+
+    const auto triangle = [&](std::size_t i) {
+        FlatMesh::Triangle t;
+        std::size_t corner = 0;
+        for (const auto& vh : mesh.fv_range(OpenMesh::FaceHandle(static_cast<int>(i)))) {
+            t[corner++] = vh.idx();
+        }
+        return t;
+    };
+
+    writeUGRID(filename, gatherArrays(mesh.n_vertices(), point, mesh.n_faces(), triangle, topo), deflate_level);
+}
+
+template<typename Bathymetry>
+void writeUGRID(const std::string& filename, const FlatMesh& mesh, const Bathymetry& topo, int deflate_level) {
+
+    const auto point = [&](std::size_t i) {
+        return mesh.getPoint(i);
+    };
+
+    const auto triangle = [&](std::size_t i) {
+        return mesh.getTriangle(i);
+    };
+
+    writeUGRID(filename, gatherArrays(mesh.numVertices(), point, mesh.numTriangles(), triangle, topo), deflate_level);
+}
+
+template void writeUGRID(const std::string&, const Mesh&, const BathymetryData&, int);
+template void writeUGRID(const std::string&, const FlatMesh&, const BathymetryData&, int);
+
+template void writeUGRID(const std::string&, const Mesh&, const TiledBathymetryData&, int);
+template void writeUGRID(const std::string&, const FlatMesh&, const TiledBathymetryData&, int);
+
+template void writeUGRID(const std::string&, const Mesh&, const CompressedBathymetryData&, int);
+template void writeUGRID(const std::string&, const FlatMesh&, const CompressedBathymetryData&, int);
+
+}
+}
+
+#endif  // OMG_REQUIRE_NETCDF
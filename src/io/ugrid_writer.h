@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <mesh/flat_mesh.h>
+#include <mesh/mesh.h>
+#include <topology/scalar_field.h>
+
+namespace omg {
+namespace io {
+
+// NetCDF-4 file following the UGRID 1.0 conventions with the node coordinates, the face-node connectivity
+// and the bathymetry at the nodes, all variables are chunked and deflated with deflate_level (0 disables it)
+// instantiated for BathymetryData, TiledBathymetryData and CompressedBathymetryData
+template<typename Bathymetry>
+void writeUGRID(const std::string& filename, const Mesh& mesh, const Bathymetry& topo, int deflate_level = 4);
+
+template<typename Bathymetry>
+void writeUGRID(const std::string& filename, const FlatMesh& mesh, const Bathymetry& topo, int deflate_level = 4);
+
+}
+}
@@ -1,6 +1,8 @@
 
 #include "vtk_writer.h"
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 
 namespace omg {
@@ -88,58 +90,288 @@ void writeLegacyVTK<int16_t>(const std::string& filename, const ScalarField<int1
 }
 
 
-void writeLegacyVTK(const std::string& filename, const LineGraph& poly) {
+void writeLegacyVTK(const std::string& filename, const LineGraph& poly, bool binary,
+                    const std::vector<CellData>& cell_data) {
+    internal::writeLegacyVTK(filename, internal::toCellArrays(poly), binary, cell_data);
+}
 
-	std::ofstream file(filename);
+void writeVTU(const std::string& filename, const LineGraph& poly, const std::vector<CellData>& cell_data) {
+    internal::writeVTU(filename, internal::toCellArrays(poly), cell_data);
+}
 
-	writeLegacyHeader(file, filename, false);
+void writeLegacyVTK(const std::string& filename, const FlatMesh& mesh, bool binary,
+                    const std::vector<CellData>& cell_data) {
+    internal::writeLegacyVTK(filename, internal::toCellArrays(mesh), binary, cell_data);
+}
 
-	file << "DATASET POLYDATA" << std::endl;
-	file << "POINTS " << poly.getPoints().size() << " float" << std::endl;
+void writeVTU(const std::string& filename, const FlatMesh& mesh, const std::vector<CellData>& cell_data) {
+    internal::writeVTU(filename, internal::toCellArrays(mesh), cell_data);
+}
 
-	for (const vec2_t& v : poly.getPoints()) {
+static bool isBigEndian() {
+    const uint16_t value = 1;
+    return *reinterpret_cast<const char*>(&value) == 0;
+}
 
-		file << v[0] << " " << v[1] << " 0.0" << "\n";
-	}
+// write the complete array at once, legacy VTK files are big endian
+template<typename T>
+static void writeBigEndian(std::ofstream& file, std::vector<T>& values) {
+    if (!isBigEndian()) {
+        #pragma omp parallel for
+        for (std::size_t i = 0; i < values.size(); i++) {
+            swapEndianess(values[i]);
+        }
+    }
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
 
-	file << "LINES " << poly.getEdges().size() << " " << poly.getEdges().size() * 3 << std::endl;
+static std::string arrayName(const std::string& name) {
+    // names must not contain whitespace
+    std::string result = name;
+    std::replace_if(result.begin(), result.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }, '_');
+    return result;
+}
 
-	for (const LineGraph::Edge& e : poly.getEdges()) {
+static void checkCellData(const std::vector<CellData>& cell_data, std::size_t num_cells) {
+    for (const CellData& data : cell_data) {
+        if (data.values.size() != num_cells) {
+            throw std::runtime_error("Cell data \"" + data.name + "\" has the wrong size");
+        }
+    }
+}
 
-		file << "2 " << e.first << " " << e.second << "\n";
-	}
+namespace internal {
 
-	file.close();
+CellArrays toCellArrays(const LineGraph& poly) {
+    CellArrays cells;
+    cells.cell_size = 2;
+    cells.vtk_type = 3;  // VTK_LINE
+
+    const std::vector<vec2_t>& points = poly.getPoints();
+    cells.points.resize(3 * points.size());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < points.size(); i++) {
+        cells.points[3 * i + 0] = static_cast<float>(points[i][0]);
+        cells.points[3 * i + 1] = static_cast<float>(points[i][1]);
+        cells.points[3 * i + 2] = 0;
+    }
+
+    const std::vector<LineGraph::Edge>& edges = poly.getEdges();
+    cells.connectivity.resize(2 * edges.size());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < edges.size(); i++) {
+        cells.connectivity[2 * i + 0] = static_cast<int64_t>(edges[i].first);
+        cells.connectivity[2 * i + 1] = static_cast<int64_t>(edges[i].second);
+    }
+
+    return cells;
 }
 
-namespace internal {
+CellArrays toCellArrays(const OpenMesh::PolyConnectivity& conn) {
+    CellArrays cells;
+    cells.cell_size = 3;
+    cells.vtk_type = 5;  // VTK_TRIANGLE
 
-void writeLegacyVTK(const std::string& filename, const OpenMesh::PolyConnectivity& conn,
-					const std::function<std::string(OpenMesh::VertexHandle)>& point) {
+    cells.connectivity.resize(3 * conn.n_faces());
 
-	std::ofstream file(filename);
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < conn.n_faces(); i++) {
 
-	writeLegacyHeader(file, filename, false);
+        std::size_t k = 3 * i;
+        for (const auto& v : conn.fv_range(OpenMesh::FaceHandle(static_cast<int>(i)))) {
+            cells.connectivity[k++] = v.idx();
+        }
+    }
 
-	file << "DATASET POLYDATA" << std::endl;
-	file << "POINTS " << conn.n_vertices() << " float" << std::endl;
+    return cells;
+}
 
-	for (const auto& v : conn.vertices()) {
-		file << point(v) << "\n";
-	}
+CellArrays toCellArrays(const FlatMesh& mesh) {
+    CellArrays cells;
+    cells.cell_size = 3;
+    cells.vtk_type = 5;  // VTK_TRIANGLE
 
-	file << "POLYGONS " << conn.n_faces() << " " << conn.n_faces() * 4 << std::endl;
+    const std::vector<vec2_t>& points = mesh.getPoints();
+    cells.points.resize(3 * points.size());
 
-	for (const auto& f : conn.faces()) {
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < points.size(); i++) {
+        cells.points[3 * i + 0] = static_cast<float>(points[i][0]);
+        cells.points[3 * i + 1] = static_cast<float>(points[i][1]);
+        cells.points[3 * i + 2] = 0;
+    }
 
-		file << "3";
-		for (const auto& v : f.vertices()) {
-			file << " " << v.idx();
-		}
-		file << "\n";
-	}
+    const std::vector<FlatMesh::Triangle>& triangles = mesh.getTriangles();
+    cells.connectivity.resize(3 * triangles.size());
 
-	file.close();
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < triangles.size(); i++) {
+        cells.connectivity[3 * i + 0] = triangles[i][0];
+        cells.connectivity[3 * i + 1] = triangles[i][1];
+        cells.connectivity[3 * i + 2] = triangles[i][2];
+    }
+
+    return cells;
+}
+
+void writeLegacyVTK(const std::string& filename, const CellArrays& cells, bool binary,
+                    const std::vector<CellData>& cell_data) {
+
+    const std::size_t num_points = cells.points.size() / 3;
+    const std::size_t num_cells = cells.connectivity.size() / cells.cell_size;
+    checkCellData(cell_data, num_cells);
+
+    std::ofstream file;
+    if (binary) {
+        file.open(filename, std::ios::binary | std::ios::out);
+    } else {
+        file.open(filename);
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+
+    writeLegacyHeader(file, filename, binary);
+
+    file << "DATASET POLYDATA" << std::endl;
+    file << "POINTS " << num_points << " float" << std::endl;
+
+    if (binary) {
+        std::vector<float> points = cells.points;
+        writeBigEndian(file, points);
+        file << "\n";
+    } else {
+        for (std::size_t i = 0; i < num_points; i++) {
+            file << cells.points[3 * i] << " " << cells.points[3 * i + 1] << " " << cells.points[3 * i + 2] << "\n";
+        }
+    }
+
+    file << (cells.cell_size == 2 ? "LINES " : "POLYGONS ") << num_cells << " "
+         << num_cells * (cells.cell_size + 1) << std::endl;
+
+    if (binary) {
+        // number of vertices followed by the indices for every cell
+        std::vector<int32_t> buffer(num_cells * (cells.cell_size + 1));
+
+        #pragma omp parallel for
+        for (std::size_t i = 0; i < num_cells; i++) {
+            const std::size_t offset = i * (cells.cell_size + 1);
+
+            buffer[offset] = static_cast<int32_t>(cells.cell_size);
+            for (std::size_t k = 0; k < cells.cell_size; k++) {
+                buffer[offset + k + 1] = static_cast<int32_t>(cells.connectivity[i * cells.cell_size + k]);
+            }
+        }
+
+        writeBigEndian(file, buffer);
+        file << "\n";
+    } else {
+        for (std::size_t i = 0; i < num_cells; i++) {
+            file << cells.cell_size;
+            for (std::size_t k = 0; k < cells.cell_size; k++) {
+                file << " " << cells.connectivity[i * cells.cell_size + k];
+            }
+            file << "\n";
+        }
+    }
+
+    if (!cell_data.empty()) {
+        file << "CELL_DATA " << num_cells << std::endl;
+    }
+
+    for (const CellData& data : cell_data) {
+        file << "SCALARS " << arrayName(data.name) << " double 1" << std::endl;
+        file << "LOOKUP_TABLE default" << std::endl;
+
+        if (binary) {
+            std::vector<real_t> values = data.values;
+            writeBigEndian(file, values);
+            file << "\n";
+        } else {
+            for (real_t v : data.values) {
+                file << v << "\n";
+            }
+        }
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+}
+
+void writeVTU(const std::string& filename, const CellArrays& cells, const std::vector<CellData>& cell_data) {
+    static_assert(sizeof(real_t) == 8, "cell data is written as Float64");
+
+    const std::size_t num_points = cells.points.size() / 3;
+    const std::size_t num_cells = cells.connectivity.size() / cells.cell_size;
+    checkCellData(cell_data, num_cells);
+
+    std::vector<int64_t> offsets(num_cells);
+    for (std::size_t i = 0; i < num_cells; i++) {
+        offsets[i] = static_cast<int64_t>((i + 1) * cells.cell_size);
+    }
+    const std::vector<uint8_t> types(num_cells, cells.vtk_type);
+
+    // raw blocks of the appended data, every block starts with its size
+    std::vector<std::pair<const char*, uint64_t>> blocks;
+    std::vector<uint64_t> block_offsets;
+
+    auto addBlock = [&](const void* data, std::size_t bytes) {
+        block_offsets.push_back(blocks.empty() ? 0 : block_offsets.back() + sizeof(uint64_t) + blocks.back().second);
+        blocks.emplace_back(static_cast<const char*>(data), bytes);
+        return block_offsets.back();
+    };
+
+    std::ofstream file(filename, std::ios::binary | std::ios::out);
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
+
+    file << "<?xml version=\"1.0\"?>\n";
+    file << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+         << (isBigEndian() ? "BigEndian" : "LittleEndian") << "\" header_type=\"UInt64\">\n";
+    file << "  <UnstructuredGrid>\n";
+    file << "    <Piece NumberOfPoints=\"" << num_points << "\" NumberOfCells=\"" << num_cells << "\">\n";
+
+    file << "      <Points>\n";
+    file << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+         << addBlock(cells.points.data(), cells.points.size() * sizeof(float)) << "\"/>\n";
+    file << "      </Points>\n";
+
+    file << "      <Cells>\n";
+    file << "        <DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\""
+         << addBlock(cells.connectivity.data(), cells.connectivity.size() * sizeof(int64_t)) << "\"/>\n";
+    file << "        <DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\""
+         << addBlock(offsets.data(), offsets.size() * sizeof(int64_t)) << "\"/>\n";
+    file << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""
+         << addBlock(types.data(), types.size()) << "\"/>\n";
+    file << "      </Cells>\n";
+
+    if (!cell_data.empty()) {
+        file << "      <CellData>\n";
+        for (const CellData& data : cell_data) {
+            file << "        <DataArray type=\"Float64\" Name=\"" << arrayName(data.name) << "\" format=\"appended\" offset=\""
+                 << addBlock(data.values.data(), data.values.size() * sizeof(real_t)) << "\"/>\n";
+        }
+        file << "      </CellData>\n";
+    }
+
+    file << "    </Piece>\n";
+    file << "  </UnstructuredGrid>\n";
+
+    file << "  <AppendedData encoding=\"raw\">\n_";
+    for (const auto& block : blocks) {
+        file.write(reinterpret_cast<const char*>(&block.second), sizeof(uint64_t));
+        file.write(block.first, block.second);
+    }
+    file << "\n  </AppendedData>\n";
+    file << "</VTKFile>\n";
+
+    if (!file.good()) {
+        throw std::runtime_error("Error writing to file: " + filename);
+    }
 }
 
 }
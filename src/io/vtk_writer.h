@@ -2,6 +2,7 @@
 
 #include <topology/scalar_field.h>
 #include <geometry/line_graph.h>
+#include <mesh/flat_mesh.h>
 #include <mesh/mesh.h>
 
 namespace omg {
@@ -10,23 +11,73 @@ namespace io {
 template<typename T>
 void writeLegacyVTK(const std::string& filename, const ScalarField<T>& data, bool binary = false);
 
-void writeLegacyVTK(const std::string& filename, const LineGraph& poly);
+// named array with one value per cell, e.g. a quality metric from analysis::mesh_quality
+struct CellData {
+    std::string name;
+    std::vector<real_t> values;
+};
+
+void writeLegacyVTK(const std::string& filename, const LineGraph& poly, bool binary = false,
+                    const std::vector<CellData>& cell_data = {});
+
+// VTK XML unstructured grid with raw appended data
+void writeVTU(const std::string& filename, const LineGraph& poly, const std::vector<CellData>& cell_data = {});
+
+void writeLegacyVTK(const std::string& filename, const FlatMesh& mesh, bool binary = false,
+                    const std::vector<CellData>& cell_data = {});
+
+void writeVTU(const std::string& filename, const FlatMesh& mesh, const std::vector<CellData>& cell_data = {});
 
 namespace internal {
 
-void writeLegacyVTK(const std::string& filename, const OpenMesh::PolyConnectivity& conn,
-					const std::function<std::string(OpenMesh::VertexHandle)>& point);
+// points and cells with a fixed number of vertices per cell
+struct CellArrays {
+    std::vector<float> points;  // x, y, z of all vertices
+    std::vector<int64_t> connectivity;  // vertex indices of all cells
+    std::size_t cell_size;
+    uint8_t vtk_type;
+};
+
+CellArrays toCellArrays(const LineGraph& poly);
+
+CellArrays toCellArrays(const FlatMesh& mesh);
+
+// only the connectivity, points depend on the mesh kernel
+CellArrays toCellArrays(const OpenMesh::PolyConnectivity& conn);
+
+void writeLegacyVTK(const std::string& filename, const CellArrays& cells, bool binary,
+                    const std::vector<CellData>& cell_data);
+
+void writeVTU(const std::string& filename, const CellArrays& cells, const std::vector<CellData>& cell_data);
+
+template<typename Traits>
+CellArrays toCellArrays(const OpenMesh::TriMesh_ArrayKernelT<Traits>& mesh) {
+    CellArrays cells = toCellArrays(static_cast<const OpenMesh::PolyConnectivity&>(mesh));
+    cells.points.resize(3 * mesh.n_vertices());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < mesh.n_vertices(); i++) {
+        const auto p = mesh.point(OpenMesh::VertexHandle(static_cast<int>(i)));
+
+        cells.points[3 * i + 0] = static_cast<float>(p[0]);
+        cells.points[3 * i + 1] = static_cast<float>(p[1]);
+        cells.points[3 * i + 2] = static_cast<float>(p[2]);
+    }
+    return cells;
+}
+
+}
+
+template<typename Traits>
+void writeLegacyVTK(const std::string& filename, const OpenMesh::TriMesh_ArrayKernelT<Traits>& mesh,
+                    bool binary = false, const std::vector<CellData>& cell_data = {}) {
+    internal::writeLegacyVTK(filename, internal::toCellArrays(mesh), binary, cell_data);
 }
 
 template<typename Traits>
-void writeLegacyVTK(const std::string& filename, const OpenMesh::TriMesh_ArrayKernelT<Traits>& mesh) {
-    auto point = [&mesh](OpenMesh::VertexHandle vh) {
-        auto p = mesh.point(vh);
-        std::stringstream ss;
-        ss << p[0] << " " << p[1] << " " << p[2];
-        return ss.str();
-    };
-    internal::writeLegacyVTK(filename, mesh, point);
+void writeVTU(const std::string& filename, const OpenMesh::TriMesh_ArrayKernelT<Traits>& mesh,
+              const std::vector<CellData>& cell_data = {}) {
+    internal::writeVTU(filename, internal::toCellArrays(mesh), cell_data);
 }
 
 }
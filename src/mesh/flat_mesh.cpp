@@ -0,0 +1,109 @@
+
+#include "flat_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace omg {
+
+FlatMesh::FlatMesh(std::size_t num_vertices, std::size_t num_triangles)
+    : points(num_vertices), triangles(num_triangles) {}
+
+void FlatMesh::removeUnusedPoints() {
+    std::vector<int> new_index(points.size(), -1);
+    for (const Triangle& t : triangles) {
+        new_index[t[0]] = new_index[t[1]] = new_index[t[2]] = 0;
+    }
+
+    // move used points to the front, keeping their order
+    int num_used = 0;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (new_index[i] == 0) {
+            points[num_used] = points[i];
+            new_index[i] = num_used++;
+        }
+    }
+    points.resize(num_used);
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < triangles.size(); i++) {
+        for (int& v : triangles[i]) {
+            v = new_index[v];
+        }
+    }
+}
+
+static int findRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];  // path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+void FlatMesh::removeSeparatedSubmeshes() {
+    if (triangles.empty()) {
+        return;
+    }
+
+    // triangles sharing an edge are next to each other after sorting by edge
+    struct TriangleEdge {
+        uint64_t key;
+        int triangle;
+
+        inline bool operator<(const TriangleEdge& other) const {
+            return key < other.key || (key == other.key && triangle < other.triangle);
+        }
+    };
+
+    std::vector<TriangleEdge> edges(3 * triangles.size());
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < triangles.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+            const uint64_t v0 = triangles[i][k];
+            const uint64_t v1 = triangles[i][(k + 1) % 3];
+            edges[3 * i + k] = {(std::min(v0, v1) << 32) | std::max(v0, v1), static_cast<int>(i)};
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    // union-find over the triangles
+    std::vector<int> parent(triangles.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    for (std::size_t i = 1; i < edges.size(); i++) {
+        if (edges[i].key == edges[i - 1].key) {
+            const int a = findRoot(parent, edges[i].triangle);
+            const int b = findRoot(parent, edges[i - 1].triangle);
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // find largest submesh
+    std::vector<real_t> area(triangles.size(), 0);
+    for (std::size_t i = 0; i < triangles.size(); i++) {
+        const vec2_t a = points[triangles[i][0]] - points[triangles[i][1]];
+        const vec2_t b = points[triangles[i][2]] - points[triangles[i][1]];
+
+        area[findRoot(parent, static_cast<int>(i))] += 0.5 * std::abs(a[0] * b[1] - a[1] * b[0]);
+    }
+
+    const int largest = static_cast<int>(std::max_element(area.begin(), area.end()) - area.begin());
+
+    // remove all but the largest
+    std::size_t num_kept = 0;
+    for (std::size_t i = 0; i < triangles.size(); i++) {
+        if (findRoot(parent, static_cast<int>(i)) == largest) {
+            triangles[num_kept++] = triangles[i];
+        }
+    }
+    triangles.resize(num_kept);
+
+    removeUnusedPoints();
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <types.h>
+
+namespace omg {
+
+// point and triangle arrays as they come from the triangulators, enough to write a mesh,
+// the halfedge structure of a Mesh is only built with buildMesh when remeshing or analysis needs it
+class FlatMesh {
+public:
+    using Triangle = std::array<int, 3>;  // indices of the corners in counterclockwise order
+
+    FlatMesh() = default;
+    FlatMesh(std::size_t num_vertices, std::size_t num_triangles);
+
+    // the setters write to separate elements, they can be called from multiple threads
+    inline void setPoint(std::size_t i, const vec2_t& p) { points[i] = p; }
+    inline void setTriangle(std::size_t i, int v0, int v1, int v2) { triangles[i] = {v0, v1, v2}; }
+
+    inline const vec2_t& getPoint(std::size_t i) const { return points[i]; }
+    inline const Triangle& getTriangle(std::size_t i) const { return triangles[i]; }
+
+    inline std::size_t numVertices() const { return points.size(); }
+    inline std::size_t numTriangles() const { return triangles.size(); }
+
+    inline std::size_t numBytes() const { return points.size() * sizeof(vec2_t) + triangles.size() * sizeof(Triangle); }
+
+    inline const std::vector<vec2_t>& getPoints() const { return points; }
+    inline const std::vector<Triangle>& getTriangles() const { return triangles; }
+
+    // invalidates all vertex indices!
+    void removeUnusedPoints();
+
+    // keeps only the largest part of triangles connected by edges, like Mesh::removeSeparatedSubmeshes
+    // invalidates all indices!
+    void removeSeparatedSubmeshes();
+
+private:
+    std::vector<vec2_t> points;
+    std::vector<Triangle> triangles;
+};
+
+}
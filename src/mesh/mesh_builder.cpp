@@ -0,0 +1,167 @@
+
+#include "mesh_builder.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace omg {
+
+// triangle halfedge 3 * f + k goes from corner k to corner k + 1,
+// halfedges of the same edge get the same key
+struct DirectedEdge {
+    uint64_t key;
+    int halfedge;
+
+    inline bool operator<(const DirectedEdge& other) const {
+        return key < other.key || (key == other.key && halfedge < other.halfedge);
+    }
+};
+
+static inline uint64_t edgeKey(int v0, int v1) {
+    const uint64_t min = std::min(v0, v1);
+    const uint64_t max = std::max(v0, v1);
+    return (min << 32) | max;
+}
+
+void buildMesh(const FlatMesh& flat, Mesh& mesh) {
+    const std::vector<vec2_t>& points = flat.getPoints();
+    const std::vector<FlatMesh::Triangle>& triangles = flat.getTriangles();
+
+    if (!fitsInt(points.size())) {
+        throw std::runtime_error("Too many vertices for the mesh");
+    }
+    if (!fitsInt(3 * triangles.size())) {
+        throw std::runtime_error("Too many triangles for the mesh");
+    }
+
+    const int num_vertices = static_cast<int>(points.size());
+    const int num_triangles = static_cast<int>(triangles.size());
+
+    for (int f = 0; f < num_triangles; f++) {
+        const FlatMesh::Triangle& t = triangles[f];
+
+        for (int v : t) {
+            if (v < 0 || v >= num_vertices) {
+                throw std::runtime_error("Invalid vertex index in triangle " + std::to_string(f));
+            }
+        }
+        if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) {
+            throw std::runtime_error("Degenerate triangle " + std::to_string(f));
+        }
+    }
+
+    const auto corner = [&](int f, int k) {
+        return triangles[f][k % 3];
+    };
+
+    // sort all triangle halfedges, so that both halfedges of an edge are next to each other,
+    // they are bucketed by their smaller vertex first and only the small buckets need sorting
+    std::vector<int> bucket_begin(num_vertices + 1, 0);
+    for (int h = 0; h < 3 * num_triangles; h++) {
+        bucket_begin[std::min(corner(h / 3, h % 3), corner(h / 3, h % 3 + 1)) + 1]++;
+    }
+    for (int v = 0; v < num_vertices; v++) {
+        bucket_begin[v + 1] += bucket_begin[v];
+    }
+
+    std::vector<DirectedEdge> directed(3 * triangles.size());
+    std::vector<int> bucket_end(bucket_begin.begin(), bucket_begin.end() - 1);
+
+    for (int h = 0; h < 3 * num_triangles; h++) {
+        const int v0 = corner(h / 3, h % 3);
+        const int v1 = corner(h / 3, h % 3 + 1);
+
+        directed[bucket_end[std::min(v0, v1)]++] = {edgeKey(v0, v1), h};
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int v = 0; v < num_vertices; v++) {
+        std::sort(directed.begin() + bucket_begin[v], directed.begin() + bucket_begin[v + 1]);
+    }
+
+    // edge e has the halfedges 2e from the smaller to the larger vertex index and 2e + 1 back,
+    // the halfedge of a triangle halfedge can be found from its direction
+    std::vector<int> halfedge_index(directed.size());
+    std::vector<int> boundary;  // triangle halfedges without an opposite triangle
+    int num_edges = 0;
+
+    for (std::size_t i = 0; i < directed.size();) {
+        std::size_t end = i + 1;
+        while (end < directed.size() && directed[end].key == directed[i].key) {
+            end++;
+        }
+
+        if (end - i > 2) {
+            throw std::runtime_error("Edge with more than two triangles");
+        }
+
+        for (std::size_t j = i; j < end; j++) {
+            const int h = directed[j].halfedge;
+            const bool forward = corner(h / 3, h % 3) < corner(h / 3, h % 3 + 1);
+
+            halfedge_index[h] = 2 * num_edges + (forward ? 0 : 1);
+        }
+
+        if (end - i == 1) {
+            boundary.push_back(directed[i].halfedge);
+        } else if (halfedge_index[directed[i].halfedge] == halfedge_index[directed[i + 1].halfedge]) {
+            throw std::runtime_error("Triangles with inconsistent orientation");
+        }
+
+        num_edges++;
+        i = end;
+    }
+
+    // allocate all elements at once, new halfedges have no face
+    mesh.clear();
+    mesh.resize(num_vertices, num_edges, triangles.size());
+
+    #pragma omp parallel for
+    for (int i = 0; i < num_vertices; i++) {
+        mesh.set_point(Mesh::VertexHandle(i), toVec3(points[i]));
+    }
+
+    #pragma omp parallel for
+    for (int f = 0; f < num_triangles; f++) {
+        const Mesh::FaceHandle fh(f);
+
+        for (int k = 0; k < 3; k++) {
+            const Mesh::HalfedgeHandle heh(halfedge_index[3 * f + k]);
+
+            mesh.set_vertex_handle(heh, Mesh::VertexHandle(corner(f, k + 1)));
+            mesh.set_face_handle(heh, fh);
+            mesh.set_next_halfedge_handle(heh, Mesh::HalfedgeHandle(halfedge_index[3 * f + (k + 1) % 3]));
+        }
+        mesh.set_halfedge_handle(fh, Mesh::HalfedgeHandle(halfedge_index[3 * f]));
+    }
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < boundary.size(); i++) {
+        const int h = boundary[i];
+        mesh.set_vertex_handle(Mesh::HalfedgeHandle(halfedge_index[h] ^ 1), Mesh::VertexHandle(corner(h / 3, h % 3)));
+    }
+
+    // outgoing halfedges, boundary vertices need a boundary halfedge
+    for (int h = 0; h < static_cast<int>(halfedge_index.size()); h++) {
+        mesh.set_halfedge_handle(Mesh::VertexHandle(corner(h / 3, h % 3)), Mesh::HalfedgeHandle(halfedge_index[h]));
+    }
+    for (int h : boundary) {
+        mesh.set_halfedge_handle(Mesh::VertexHandle(corner(h / 3, h % 3 + 1)), Mesh::HalfedgeHandle(halfedge_index[h] ^ 1));
+    }
+
+    // the next boundary halfedge is found by rotating through the triangles around the end vertex,
+    // this also works for vertices with multiple boundaries
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < boundary.size(); i++) {
+        const Mesh::HalfedgeHandle heh(halfedge_index[boundary[i]] ^ 1);
+
+        Mesh::HalfedgeHandle next = mesh.opposite_halfedge_handle(heh);
+        do {
+            next = mesh.opposite_halfedge_handle(mesh.prev_halfedge_handle(next));
+        } while (!mesh.is_boundary(next));
+
+        mesh.set_next_halfedge_handle(heh, next);
+    }
+}
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mesh/flat_mesh.h>
+#include <mesh/mesh.h>
+
+namespace omg {
+
+// builds the halfedge structure of a Mesh from the triangle arrays in one go, replaces the content of mesh,
+// all arrays are allocated once and the halfedges are connected with a single sorted pass over the edges,
+// this is much faster than adding the triangles one by one with add_face
+// throws if an edge has more than two triangles or two triangles have opposite orientation
+void buildMesh(const FlatMesh& flat, Mesh& mesh);
+
+}
@@ -12,28 +12,47 @@
 #include <geometry/line_graph.h>
 #include <geometry/he_polygon.h>
 
+#include <io/async_writer.h>
 #include <io/bin32_reader.h>
 #include <io/csv_writer.h>
+#include <io/grid_file.h>
+#include <io/mapped_file.h>
 #ifdef OMG_REQUIRE_NETCDF
 #include <io/nc_reader.h>
 #endif  // OMG_REQUIRE_NETCDF
 #include <io/nod2d_writer.h>
 #include <io/off_writer.h>
 #include <io/poly_reader.h>
+#include <io/tile_file.h>
+#ifdef OMG_REQUIRE_NETCDF
+#include <io/ugrid_writer.h>
+#endif  // OMG_REQUIRE_NETCDF
 #include <io/vtk_writer.h>
 
 #include <mesh/mesh.h>
+#include <mesh/flat_mesh.h>
+#include <mesh/mesh_builder.h>
 #include <mesh/remeshing.h>
 
 #include <size_function/constant_size.h>
+#include <size_function/fast_size_query.h>
 #include <size_function/gradient_limiting.h>
 #include <size_function/reference_size.h>
 
+#include <topology/compressed_scalar_field.h>
+#include <topology/grid_allocator.h>
 #include <topology/scalar_field.h>
+#include <topology/scalar_field_pyramid.h>
+#include <topology/tiled_scalar_field.h>
 
 #include <triangulation/acute_triangulator.h>
+#include <triangulation/interior_seeding.h>
+#include <triangulation/jigsaw_session.h>
 #include <triangulation/jigsaw_triangulator.h>
+#include <triangulation/parallel_triangulator.h>
+#include <triangulation/region_remeshing.h>
 #include <triangulation/triangle_triangulator.h>
+#include <triangulation/triangulation_stats.h>
 
 #include <types.h>
 #include <util.h>
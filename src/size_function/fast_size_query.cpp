@@ -0,0 +1,140 @@
+
+#include "fast_size_query.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace omg {
+
+static inline real_t sqr(real_t x) {
+    return x * x;
+}
+
+FastSizeQuery::FastSizeQuery(const SizeFunction& size, std::size_t block_size)
+    : size(size), block_size(std::max<std::size_t>(block_size, 1)) {
+
+    const size2_t& grid_size = size.getGridSize();
+
+    // periodic fields have an additional cell from the last to the first column
+    num_cells = size2_t(size.isPeriodic() ? grid_size[0] : grid_size[0] - 1, grid_size[1] - 1);
+    num_blocks = (num_cells + size2_t(this->block_size - 1)) / this->block_size;
+    inv_cell_size = vec2_t(1 / size.getCellSize()[0], 1 / size.getCellSize()[1]);
+
+    blocks.resize(num_blocks[0] * num_blocks[1]);
+
+    #pragma omp parallel for schedule(static)
+    for (std::size_t by = 0; by < num_blocks[1]; by++) {
+        for (std::size_t bx = 0; bx < num_blocks[0]; bx++) {
+
+            // interpolated values are bounded by the corners of all cells in the block
+            real_t min = std::numeric_limits<real_t>::max();
+            real_t max = std::numeric_limits<real_t>::lowest();
+
+            const std::size_t j_end = std::min((by + 1) * this->block_size, grid_size[1] - 1);
+            const std::size_t i_end = std::min((bx + 1) * this->block_size, num_cells[0]);
+
+            for (std::size_t j = by * this->block_size; j <= j_end; j++) {
+                for (std::size_t k = bx * this->block_size; k <= i_end; k++) {
+                    const real_t value = size.grid(k % grid_size[0], j);
+                    min = std::min(min, value);
+                    max = std::max(max, value);
+                }
+            }
+
+            // non-positive sizes are never good
+            BlockLimits& limits = blocks[bx + by * num_blocks[0]];
+            limits.accept = min > 0 ? sqr(SizeFunction::MAX_SIZE_FACTOR * min) : 0;
+            limits.reject = max > 0 ? sqr(SizeFunction::MAX_SIZE_FACTOR * max) : 0;
+        }
+    }
+}
+
+const FastSizeQuery::BlockLimits* FastSizeQuery::findBlock(const vec2_t& point) const {
+    const AxisAlignedBoundingBox& aabb = size.getBoundingBox();
+    const vec2_t p = size.wrapPoint(point);
+
+    const real_t max_x = size.isPeriodic() ? aabb.min[0] + size.getPeriod() : aabb.max[0];
+    if (p[0] < aabb.min[0] || p[1] < aabb.min[1] || p[0] > max_x || p[1] > aabb.max[1]) {
+        return nullptr;
+    }
+
+    // cell like in ScalarField::getSurroundingCell, the border belongs to the last cell
+    const std::size_t i = std::min(static_cast<std::size_t>((p[0] - aabb.min[0]) * inv_cell_size[0]), num_cells[0] - 1);
+    const std::size_t j = std::min(static_cast<std::size_t>((p[1] - aabb.min[1]) * inv_cell_size[1]), num_cells[1] - 1);
+
+    return &blocks[i / block_size + (j / block_size) * num_blocks[0]];
+}
+
+bool FastSizeQuery::exactTest(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2, real_t max_sqr_length) const {
+    exact.value.fetch_add(1, std::memory_order_relaxed);
+
+    const real_t min_size = std::min({size.getValue(v0), size.getValue(v1), size.getValue(v2)});
+
+    const bool good = min_size > 0 && max_sqr_length < sqr(SizeFunction::MAX_SIZE_FACTOR * min_size);
+    if (good) {
+        exact_good.value.fetch_add(1, std::memory_order_relaxed);
+    }
+    return good;
+}
+
+bool FastSizeQuery::isTriangleGood(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2) const {
+    thread_local uint32_t call = 0;
+    if (++call % TIME_SAMPLING != 0) {
+        return test(v0, v1, v2);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool good = test(v0, v1, v2);
+    const auto end = std::chrono::steady_clock::now();
+
+    sampled_nanoseconds.value.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                                        std::memory_order_relaxed);
+    return good;
+}
+
+bool FastSizeQuery::test(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2) const {
+    const real_t max_sqr_length = std::max({(v0 - v1).sqrnorm(), (v0 - v2).sqrnorm(), (v1 - v2).sqrnorm()});
+
+    const BlockLimits* b0 = findBlock(v0);
+    const BlockLimits* b1 = findBlock(v1);
+    const BlockLimits* b2 = findBlock(v2);
+
+    // the exact test reports points out of bounds
+    if (!b0 || !b1 || !b2) {
+        return exactTest(v0, v1, v2, max_sqr_length);
+    }
+
+    // the smallest size at the corners is between the smallest block minimum and the smallest block maximum
+    if (max_sqr_length < std::min({b0->accept, b1->accept, b2->accept})) {
+        accepted.value.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (max_sqr_length >= std::min({b0->reject, b1->reject, b2->reject})) {
+        rejected.value.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return exactTest(v0, v1, v2, max_sqr_length);
+}
+
+FastSizeQuery::Statistics FastSizeQuery::getStatistics() const {
+    Statistics stats;
+    stats.accepted = accepted.value.load(std::memory_order_relaxed);
+    stats.rejected = rejected.value.load(std::memory_order_relaxed);
+    stats.exact = exact.value.load(std::memory_order_relaxed);
+    stats.exact_good = exact_good.value.load(std::memory_order_relaxed);
+    stats.time = 1e-9 * TIME_SAMPLING * sampled_nanoseconds.value.load(std::memory_order_relaxed);
+    return stats;
+}
+
+FastSizeQuery::Statistics& FastSizeQuery::Statistics::operator+=(const Statistics& other) {
+    accepted += other.accepted;
+    rejected += other.rejected;
+    exact += other.exact;
+    exact_good += other.exact_good;
+    time += other.time;
+    return *this;
+}
+
+}
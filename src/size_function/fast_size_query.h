@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <size_function/size_function.h>
+
+namespace omg {
+
+// same test as SizeFunction::isTriangleGood for the triunsuitable callbacks of the triangulators:
+// the size bounds of coarse blocks of grid cells decide most triangles without interpolation,
+// only triangles close to the threshold are tested exactly, all comparisons use squared lengths
+class FastSizeQuery {
+public:
+    // how often each path was taken
+    struct Statistics {
+        uint64_t accepted = 0;  // good by the block bounds
+        uint64_t rejected = 0;  // bad by the block bounds
+        uint64_t exact = 0;  // interpolated the size function
+        uint64_t exact_good = 0;  // good by the exact test
+
+        // seconds in isTriangleGood summed over all threads, estimated from every TIME_SAMPLING-th call
+        double time = 0;
+
+        inline uint64_t calls() const { return accepted + rejected + exact; }
+        inline uint64_t good() const { return accepted + exact_good; }
+
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    // timing every call would cost more than the block test itself
+    static constexpr uint32_t TIME_SAMPLING = 16;
+
+    explicit FastSizeQuery(const SizeFunction& size, std::size_t block_size = 8);
+
+    bool isTriangleGood(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2) const;
+
+    Statistics getStatistics() const;
+
+private:
+    // squared edge lengths that are definitely good or bad for all sizes in the block
+    struct BlockLimits {
+        real_t accept;
+        real_t reject;
+    };
+
+    const SizeFunction& size;
+    const std::size_t block_size;
+
+    size2_t num_cells;
+    size2_t num_blocks;
+    vec2_t inv_cell_size;
+
+    std::vector<BlockLimits> blocks;
+
+    // points outside the size function return nullptr
+    const BlockLimits* findBlock(const vec2_t& point) const;
+
+    bool test(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2) const;
+    bool exactTest(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2, real_t max_sqr_length) const;
+
+    // counters in separate cache lines, the callbacks may run on several threads
+    struct alignas(64) Counter {
+        mutable std::atomic<uint64_t> value{0};
+    };
+
+    Counter accepted, rejected, exact, exact_good, sampled_nanoseconds;
+};
+
+}
@@ -110,9 +110,9 @@ void simpleGradientLimiting(SizeFunction& size, real_t limit, real_t time_step,
         changed = 0;
 
         // iterate over all points
-        #pragma omp parallel for
-        for (std::size_t i = 0; i < size.getGridSize()[0]; i++) {
-            for (std::size_t j = 0; j < size.getGridSize()[1]; j++) {
+        #pragma omp parallel for schedule(static) reduction(+:changed)
+        for (std::size_t j = 0; j < grid_size[1]; j++) {
+            for (std::size_t i = 0; i < grid_size[0]; i++) {
 
                 const size2_t idx(i, j);
                 const real_t current = old_size->grid(idx);
@@ -267,7 +267,7 @@ private:
             return grid[i0] > grid[i1];
         }
 
-        const std::vector<real_t>& grid;
+        const SizeFunction::Grid& grid;
     };
 public:
     const Comparator compare;
@@ -8,7 +8,6 @@ JigsawSizeFunction::JigsawSizeFunction(const SizeFunction& size)
 
     x_buffer.reserve(grid_size[0]);
     y_buffer.reserve(grid_size[1]);
-    value_buffer.reserve(grid_size[0] * grid_size[1]);
 
     for (std::size_t x = 0; x < grid_size[0]; x++) {
 
@@ -21,12 +20,8 @@ JigsawSizeFunction::JigsawSizeFunction(const SizeFunction& size)
         y_buffer.push_back(p[1]);
     }
 
-    for (std::size_t x = 0; x < grid_size[0]; x++) {
-        for (std::size_t y = 0; y < grid_size[1]; y++) {
-
-            value_buffer.push_back(size.grid(x, y));
-        }
-    }
+    value_buffer.resize(grid_size[0] * grid_size[1]);
+    update(size);
 
     jigsaw_init_msh_t(&h_fun);
 
@@ -42,6 +37,34 @@ JigsawSizeFunction::JigsawSizeFunction(const SizeFunction& size)
     h_fun._ygrid._size = y_buffer.size();
 }
 
+bool JigsawSizeFunction::hasSameGrid(const SizeFunction& size) const {
+    return grid_size == size.getGridSize()
+        && aabb.min == size.getBoundingBox().min && aabb.max == size.getBoundingBox().max;
+}
+
+bool JigsawSizeFunction::update(const SizeFunction& size) {
+    if (!hasSameGrid(size)) {
+        throw std::runtime_error("Wrong grid");
+    }
+
+    bool changed = false;
+
+    #pragma omp parallel for reduction(||:changed)
+    for (std::size_t x = 0; x < grid_size[0]; x++) {
+        for (std::size_t y = 0; y < grid_size[1]; y++) {
+
+            const ::fp32_t value = static_cast<::fp32_t>(size.grid(x, y));
+            ::fp32_t& stored = value_buffer[x * grid_size[1] + y];
+
+            if (stored != value) {
+                stored = value;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
 void JigsawSizeFunction::setGradientLimit(real_t limit) {
     if (slope_buffer.empty()) {
         slope_buffer.resize(value_buffer.size());
@@ -10,6 +10,12 @@ class JigsawSizeFunction {
 public:
     explicit JigsawSizeFunction(const SizeFunction& size);
 
+    // the axes are only computed once, a size function on the same grid just overwrites the values
+    bool hasSameGrid(const SizeFunction& size) const;
+
+    // only writes the values that differ, returns false if none changed
+    bool update(const SizeFunction& size);
+
     void setGradientLimit(real_t limit);
 
     void toSizeFunction(SizeFunction& size) const;
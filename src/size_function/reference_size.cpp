@@ -4,6 +4,8 @@
 #include <iostream>
 #include <chrono>
 
+#include <topology/compressed_scalar_field.h>
+#include <topology/tiled_scalar_field.h>
 #include <util.h>
 
 namespace omg {
@@ -31,24 +33,22 @@ real_t AreaOfInterest::blendResolution(real_t current_resolution, const vec2_t&
 }
 
 
-ReferenceSize::ReferenceSize(const BathymetryData& data, const Resolution& resolution, real_t coast_height)
+template<typename Bathymetry>
+ReferenceSize::ReferenceSize(const Bathymetry& data, const Resolution& resolution, real_t coast_height)
     : SizeFunction(data.getBoundingBox(), data.getGridSize()) {
 
     max = metersToDegrees(resolution.coarsest);
 
     ScopeTimer timer("Reference size");
 
-    #pragma omp parallel for
-    for (std::size_t i = 0; i < grid_size[0]; i++) {
-        for (std::size_t j = 0; j < grid_size[1]; j++) {
-
-            const size2_t idx(i, j);
-            grid(idx) = calculateSize(idx, data, resolution, coast_height);
-        }
-    }
+    // traversed in the blocks of the bathymetry, rows for BathymetryData like in the first touch of the grid
+    parallelForBlocks(grid_size, data.getBlockSize(), [&](const size2_t& idx) {
+        grid(idx) = calculateSize(idx, data, resolution, coast_height);
+    });
 }
 
-real_t ReferenceSize::calculateSize(const size2_t& idx, const BathymetryData& data, const Resolution& res,
+template<typename Bathymetry>
+real_t ReferenceSize::calculateSize(const size2_t& idx, const Bathymetry& data, const Resolution& res,
                                     real_t coast_height) const {
 
     const vec2_t position = getPoint(idx);
@@ -87,4 +87,9 @@ real_t ReferenceSize::calculateSize(const size2_t& idx, const BathymetryData& da
     return actual_size;
 }
 
+
+template ReferenceSize::ReferenceSize(const BathymetryData&, const Resolution&, real_t);
+template ReferenceSize::ReferenceSize(const TiledBathymetryData&, const Resolution&, real_t);
+template ReferenceSize::ReferenceSize(const CompressedBathymetryData&, const Resolution&, real_t);
+
 }
@@ -32,10 +32,13 @@ struct Resolution {
 
 class ReferenceSize : public SizeFunction {
 public:
-    ReferenceSize(const BathymetryData& data, const Resolution& resolution, real_t coast_height = 0);
+    // instantiated for BathymetryData, TiledBathymetryData and CompressedBathymetryData
+    template<typename Bathymetry>
+    ReferenceSize(const Bathymetry& data, const Resolution& resolution, real_t coast_height = 0);
 
 private:
-    real_t calculateSize(const size2_t& idx, const BathymetryData& data, const Resolution& res,
+    template<typename Bathymetry>
+    real_t calculateSize(const size2_t& idx, const Bathymetry& data, const Resolution& res,
                          real_t coast_height) const;
 };
 
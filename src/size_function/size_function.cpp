@@ -30,7 +30,7 @@ bool SizeFunction::isTriangleGood(const vec2_t& v0, const vec2_t& v1, const vec2
     const real_t length2 = (v1 - v2).sqrnorm();
     const real_t max_length = std::sqrt(std::max({length0, length1, length2}));
 
-    return max_length < min_size * 1.3;
+    return max_length < min_size * MAX_SIZE_FACTOR;
 }
 
 void SizeFunction::find_max() {
@@ -11,6 +11,9 @@ public:
     SizeFunction(const ScalarField<real_t>& scalar_field);
     SizeFunction(ScalarField<real_t>&& scalar_field);
 
+    // a triangle is good if its longest edge is shorter than the smallest size at its corners times this factor
+    static constexpr real_t MAX_SIZE_FACTOR = 1.3;
+
     // return true if the triangle (v0, v1, v2) satisfies the size constraints
     bool isTriangleGood(const vec2_t& v0, const vec2_t& v1, const vec2_t& v2) const;
 
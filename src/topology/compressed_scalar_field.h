@@ -0,0 +1,379 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include <topology/scalar_field.h>
+
+namespace omg {
+
+// read-only scalar field of integral values stored in compressed tiles
+// every tile stores the differences to the previous value bit-packed with the width of the largest difference,
+// flat tiles need no data at all. accessed tiles are decoded into a small cache per thread
+template<typename T>
+class CompressedScalarField : public GridGeometry {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "compression is only defined for small integral values");
+
+public:
+    // reads the rows [first_row, first_row + num_rows) row-major into dst
+    using RowReader = std::function<void(std::size_t first_row, std::size_t num_rows, T* dst)>;
+
+    // compress rows read from any source, only one row of tiles is kept uncompressed at a time
+    CompressedScalarField(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size, const RowReader& read_rows,
+                          bool periodic = false, std::size_t tile_size = 64);
+
+    explicit CompressedScalarField(const ScalarField<T>& field, std::size_t tile_size = 64);
+
+    // specify type only used for interpolation
+    template<typename Type = DefaultType,
+             typename S = typename std::conditional<std::is_same<Type, DefaultType>::value, T, Type>::type>
+    S getValue(const vec2_t& point) const;
+
+    vec2_t getGradient(const vec2_t& point) const;
+
+    vec2_t computeGradient(const size2_t& idx) const;
+
+    inline std::size_t getTileSize() const { return tile_size; }
+
+    // traversal order for parallel loops over the grid, tile by tile
+    inline size2_t getBlockSize() const { return size2_t(tile_size); }
+
+    inline T grid(std::size_t i, std::size_t j) const { return grid(size2_t(i, j)); }
+    T grid(const size2_t& idx) const;
+
+    // call f(idx, value) for all grid points, tile by tile
+    template<typename Function>
+    void forEach(Function f) const;
+
+    ScalarField<T> decompress() const;
+
+    // size of the compressed data in bytes
+    std::size_t memoryUsage() const;
+
+private:
+    struct TileHeader {
+        T first;
+        uint8_t bits;        // bits per packed difference
+        std::size_t offset;  // first word in data
+    };
+
+    // decoded tiles of all compressed fields, identified by field id and tile index
+    struct ThreadCache {
+        static constexpr std::size_t SIZE = 8;
+
+        struct Entry {
+            std::size_t field_id = 0;  // zero is never used as id
+            std::size_t tile = 0;
+            std::vector<T> values;
+        };
+
+        std::array<Entry, SIZE> entries;
+        std::size_t next = 0;
+    };
+
+    const std::size_t tile_size;
+    const size2_t tile_count;
+
+    // copies share the id, the data never changes
+    const std::size_t id;
+
+    std::vector<TileHeader> tiles;
+    std::vector<uint64_t> data;
+
+    inline size2_t tileSize(const size2_t& tile_idx) const;
+
+    // values of the tile containing the grid index, valid until the next cache miss of this thread
+    const std::vector<T>& decodedTile(const size2_t& tile_idx) const;
+
+    void decodeTile(std::size_t tile, const size2_t& size, T* dst) const;
+
+    static TileHeader encodeTile(const T* src, std::size_t stride, const size2_t& size, std::vector<uint64_t>& words);
+
+    static std::size_t validTileSize(std::size_t tile_size) {
+        if (tile_size == 0) {
+            throw std::runtime_error("tile size must not be zero");
+        }
+        return tile_size;
+    }
+
+    static std::size_t nextId() {
+        static std::atomic<std::size_t> counter(1);
+        return counter++;
+    }
+
+    static ThreadCache& threadCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+};
+
+using CompressedBathymetryData = CompressedScalarField<int16_t>;
+
+
+// ---------------------- implementation ----------------------
+
+template<typename T>
+CompressedScalarField<T>::CompressedScalarField(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size,
+                                                const RowReader& read_rows, bool periodic, std::size_t tile_size)
+    : GridGeometry(aabb, grid_size, periodic), tile_size(validTileSize(tile_size)),
+      tile_count((grid_size + size2_t(this->tile_size - 1)) / this->tile_size), id(nextId()) {
+
+    tiles.resize(tile_count[0] * tile_count[1]);
+
+    std::vector<T> rows(grid_size[0] * tile_size);
+    std::vector<std::vector<uint64_t>> packed(tile_count[0]);
+
+    for (std::size_t tj = 0; tj < tile_count[1]; tj++) {
+        const std::size_t first_row = tj * tile_size;
+        read_rows(first_row, std::min(tile_size, grid_size[1] - first_row), rows.data());
+
+        // compress all tiles of this row
+        #pragma omp parallel for schedule(dynamic)
+        for (std::size_t ti = 0; ti < tile_count[0]; ti++) {
+            packed[ti].clear();
+            tiles[ti + tj * tile_count[0]] = encodeTile(rows.data() + ti * tile_size, grid_size[0],
+                                                        tileSize({ti, tj}), packed[ti]);
+        }
+
+        // append to data
+        for (std::size_t ti = 0; ti < tile_count[0]; ti++) {
+            tiles[ti + tj * tile_count[0]].offset = data.size();
+            data.insert(data.end(), packed[ti].begin(), packed[ti].end());
+        }
+    }
+
+    data.shrink_to_fit();
+}
+
+template<typename T>
+CompressedScalarField<T>::CompressedScalarField(const ScalarField<T>& field, std::size_t tile_size)
+    : CompressedScalarField(field.getBoundingBox(), field.getGridSize(),
+                            [&field](std::size_t first_row, std::size_t num_rows, T* dst) {
+                                const std::size_t width = field.getGridSize()[0];
+                                std::copy_n(field.grid().begin() + first_row * width, num_rows * width, dst);
+                            },
+                            field.isPeriodic(), tile_size) {}
+
+template<typename T>
+template<typename Type, typename S>
+S CompressedScalarField<T>::getValue(const vec2_t& point) const {
+
+    // if a non floating point type is implicitly used, show a warning
+    static_assert(!std::is_same<Type, DefaultType>::value || std::is_floating_point<S>::value,
+                  "implicit non floating point interpolation used");
+
+    return interpolate<S>(point, [this](const size2_t& idx) { return grid(idx); });
+}
+
+template<typename T>
+vec2_t CompressedScalarField<T>::getGradient(const vec2_t& point) const {
+
+    static_assert(std::is_convertible<T, real_t>::value, "gradient is only defined on scalar values");
+
+    return interpolate<vec2_t>(point, [this](const size2_t& idx) { return computeGradient(idx); });
+}
+
+template<typename T>
+vec2_t CompressedScalarField<T>::computeGradient(const size2_t& idx) const {
+    return gradientStencil(idx, [this](const size2_t& i) { return grid(i); });
+}
+
+template<typename T>
+T CompressedScalarField<T>::grid(const size2_t& idx) const {
+    if (idx[0] >= grid_size[0] || idx[1] >= grid_size[1]) {
+        throw std::runtime_error("Trying to access compressed scalar field out of bounds");
+    }
+
+    const size2_t tile_idx = idx / tile_size;
+    const std::vector<T>& values = decodedTile(tile_idx);
+
+    const size2_t local = idx - tile_idx * tile_size;
+    return values[local[0] + local[1] * tileSize(tile_idx)[0]];
+}
+
+template<typename T>
+template<typename Function>
+void CompressedScalarField<T>::forEach(Function f) const {
+    std::vector<T> values(tile_size * tile_size);
+
+    for (std::size_t tj = 0; tj < tile_count[1]; tj++) {
+        for (std::size_t ti = 0; ti < tile_count[0]; ti++) {
+
+            const size2_t size = tileSize({ti, tj});
+            decodeTile(ti + tj * tile_count[0], size, values.data());
+
+            for (std::size_t j = 0; j < size[1]; j++) {
+                for (std::size_t i = 0; i < size[0]; i++) {
+                    f(size2_t(ti * tile_size + i, tj * tile_size + j), values[i + j * size[0]]);
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+ScalarField<T> CompressedScalarField<T>::decompress() const {
+    ScalarField<T> field(aabb, grid_size, period != 0);
+
+    #pragma omp parallel
+    {
+        std::vector<T> values(tile_size * tile_size);
+
+        #pragma omp for collapse(2) schedule(static)
+        for (std::size_t tj = 0; tj < tile_count[1]; tj++) {
+            for (std::size_t ti = 0; ti < tile_count[0]; ti++) {
+
+                const size2_t size = tileSize({ti, tj});
+                decodeTile(ti + tj * tile_count[0], size, values.data());
+
+                for (std::size_t j = 0; j < size[1]; j++) {
+                    std::copy_n(values.begin() + j * size[0], size[0],
+                                field.grid().begin() + field.linearIndex({ti * tile_size, tj * tile_size + j}));
+                }
+            }
+        }
+    }
+
+    return field;
+}
+
+template<typename T>
+std::size_t CompressedScalarField<T>::memoryUsage() const {
+    return data.size() * sizeof(uint64_t) + tiles.size() * sizeof(TileHeader);
+}
+
+template<typename T>
+inline size2_t CompressedScalarField<T>::tileSize(const size2_t& tile_idx) const {
+    const size2_t origin = tile_idx * tile_size;
+    return {std::min(tile_size, grid_size[0] - origin[0]), std::min(tile_size, grid_size[1] - origin[1])};
+}
+
+template<typename T>
+const std::vector<T>& CompressedScalarField<T>::decodedTile(const size2_t& tile_idx) const {
+    const std::size_t tile = tile_idx[0] + tile_idx[1] * tile_count[0];
+
+    ThreadCache& cache = threadCache();
+
+    for (const auto& entry : cache.entries) {
+        if (entry.field_id == id && entry.tile == tile) {
+            return entry.values;
+        }
+    }
+
+    // replace the oldest entry
+    auto& entry = cache.entries[cache.next];
+    cache.next = (cache.next + 1) % ThreadCache::SIZE;
+
+    const size2_t size = tileSize(tile_idx);
+    entry.field_id = id;
+    entry.tile = tile;
+    entry.values.resize(size[0] * size[1]);
+    decodeTile(tile, size, entry.values.data());
+
+    return entry.values;
+}
+
+template<typename T>
+void CompressedScalarField<T>::decodeTile(std::size_t tile, const size2_t& size, T* dst) const {
+    const TileHeader& header = tiles[tile];
+
+    if (header.bits == 0) {
+        std::fill_n(dst, size[0] * size[1], header.first);
+        return;
+    }
+
+    const uint64_t* words = data.data() + header.offset;
+    const uint64_t mask = (uint64_t(1) << header.bits) - 1;
+
+    std::size_t bit = 0;
+    for (std::size_t k = 0; k < size[0] * size[1]; k++, bit += header.bits) {
+
+        // unpack, the value can be split over two words
+        const std::size_t w = bit / 64;
+        const std::size_t shift = bit % 64;
+
+        uint64_t z = words[w] >> shift;
+        if (shift + header.bits > 64) {
+            z |= words[w + 1] << (64 - shift);
+        }
+        z &= mask;
+
+        // undo zigzag encoding
+        const int64_t delta = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+
+        // predecessor is the left neighbor or the first value of the previous row
+        int64_t prev;
+        if (k == 0) {
+            prev = header.first;
+        } else if (k % size[0] != 0) {
+            prev = dst[k - 1];
+        } else {
+            prev = dst[k - size[0]];
+        }
+
+        dst[k] = static_cast<T>(prev + delta);
+    }
+}
+
+template<typename T>
+typename CompressedScalarField<T>::TileHeader CompressedScalarField<T>::encodeTile(const T* src, std::size_t stride,
+                                                                                   const size2_t& size,
+                                                                                   std::vector<uint64_t>& words) {
+    TileHeader header;
+    header.first = src[0];
+    header.offset = 0;
+
+    // zigzag encoded differences to the predecessor
+    std::vector<uint64_t> diffs(size[0] * size[1]);
+    uint64_t max = 0;
+
+    for (std::size_t j = 0; j < size[1]; j++) {
+        for (std::size_t i = 0; i < size[0]; i++) {
+
+            int64_t prev;
+            if (i > 0) {
+                prev = src[i - 1 + j * stride];
+            } else if (j > 0) {
+                prev = src[(j - 1) * stride];
+            } else {
+                prev = header.first;
+            }
+
+            const int64_t delta = static_cast<int64_t>(src[i + j * stride]) - prev;
+            const uint64_t z = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+
+            diffs[i + j * size[0]] = z;
+            max = std::max(max, z);
+        }
+    }
+
+    header.bits = 0;
+    while (max >> header.bits) {
+        header.bits++;
+    }
+
+    if (header.bits == 0) {
+        return header;  // constant tile
+    }
+
+    // pack differences
+    words.assign((diffs.size() * header.bits + 63) / 64, 0);
+
+    std::size_t bit = 0;
+    for (uint64_t z : diffs) {
+        const std::size_t w = bit / 64;
+        const std::size_t shift = bit % 64;
+
+        words[w] |= z << shift;
+        if (shift + header.bits > 64) {
+            words[w + 1] |= z >> (64 - shift);
+        }
+        bit += header.bits;
+    }
+
+    return header;
+}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace omg {
+
+struct GridAllocationPolicy {
+    // advise transparent huge pages for grids of at least one huge page
+    bool huge_pages = false;
+};
+
+// global policy used by all scalar field grids
+inline GridAllocationPolicy& gridAllocationPolicy() {
+    static GridAllocationPolicy policy;
+    return policy;
+}
+
+// allocator for scalar field grids with cache line alignment
+// elements are default initialized, so the pages are not touched until the grid is filled
+// this allows the first touch to happen in parallel and places the pages on the NUMA node of the thread using them
+template<typename T>
+class GridAllocator {
+public:
+    using value_type = T;
+
+    static constexpr std::size_t ALIGNMENT = 64;
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 << 20;
+
+    template<typename U>
+    struct rebind {
+        using other = GridAllocator<U>;
+    };
+
+    GridAllocator() noexcept = default;
+
+    template<typename U>
+    GridAllocator(const GridAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n) noexcept;
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const GridAllocator<T>&, const GridAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+inline bool operator!=(const GridAllocator<T>&, const GridAllocator<U>&) { return false; }
+
+
+// ---------------------- implementation ----------------------
+
+template<typename T>
+T* GridAllocator<T>::allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+
+    const bool huge_pages = gridAllocationPolicy().huge_pages && n * sizeof(T) >= HUGE_PAGE_SIZE;
+    const std::size_t alignment = huge_pages ? HUGE_PAGE_SIZE : ALIGNMENT;
+
+    // size has to be a multiple of the alignment
+    const std::size_t bytes = (n * sizeof(T) + alignment - 1) / alignment * alignment;
+
+#ifdef _WIN32
+    void* p = _aligned_malloc(bytes, alignment);
+#else
+    void* p = std::aligned_alloc(alignment, bytes);
+#endif
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+        madvise(p, bytes, MADV_HUGEPAGE);  // only a hint, ignore errors
+    }
+#endif
+
+    return static_cast<T*>(p);
+}
+
+template<typename T>
+void GridAllocator<T>::deallocate(T* p, std::size_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include <types.h>
+
+namespace omg {
+
+// positions of the sample points of a regular grid and the stencils on them,
+// shared by all scalar field representations, which only differ in how a value is stored
+// the bounding box aligns with the outermost sample points
+// so sample points lie at the corners of cells, not in the center
+// periodic grids wrap around in x direction, the last column is followed by the first one
+class GridGeometry {
+public:
+    GridGeometry(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size, bool periodic = false);
+
+    inline const AxisAlignedBoundingBox& getBoundingBox() const { return aabb; }
+    inline const size2_t& getGridSize() const { return grid_size; }
+    inline const vec2_t& getCellSize() const { return cell_size; }
+
+    inline bool isPeriodic() const { return period != 0; }
+    inline real_t getPeriod() const { return period; }
+
+    inline vec2_t getPoint(const size2_t& idx) const { return aabb.min + toVec2(idx) * cell_size; }
+
+    // move the x coordinate into [aabb.min, aabb.min + period) for periodic fields
+    inline vec2_t wrapPoint(const vec2_t& point) const;
+
+    inline std::size_t linearIndex(const size2_t& idx) const;
+    inline size2_t gridIndex(std::size_t linear_idx) const;
+
+protected:
+    const AxisAlignedBoundingBox aabb;
+
+    const size2_t grid_size;
+    const vec2_t cell_size;
+
+    const real_t period;  // zero if not periodic
+
+    // minimum corner index and coordinates of the corners of the cell containing the point
+    inline size2_t getSurroundingCell(const vec2_t& point, vec2_t& min, vec2_t& max) const;
+
+    // next column index, wraps around for periodic fields
+    inline std::size_t nextColumn(std::size_t i) const { return (period != 0 && i + 1 == grid_size[0]) ? 0 : i + 1; }
+
+    // bilinear interpolation of get(idx) at the corners of the cell containing the point
+    template<typename S, typename Get>
+    inline S interpolate(const vec2_t& point, Get get) const;
+
+    // gradient at a grid point from the values get(idx), central differences if possible
+    template<typename Get>
+    inline vec2_t gradientStencil(const size2_t& idx, Get get) const;
+
+    template<typename S>
+    static inline S bilinearInterpolation(const S& f11, const S& f12, const S& f21, const S& f22, const vec2_t& factor);
+};
+
+
+// calls f(idx) for all grid indices in [0, size), the blocks are distributed over the threads,
+// fields stored in tiles are traversed tile by tile this way
+// the first exception thrown by f is rethrown after the loop, the remaining blocks are skipped
+template<typename Function>
+void parallelForBlocks(const size2_t& size, const size2_t& block, Function f) {
+    const size2_t num_blocks = (size + block - size2_t(1)) / block;
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (std::size_t bj = 0; bj < num_blocks[1]; bj++) {
+        for (std::size_t bi = 0; bi < num_blocks[0]; bi++) {
+            {
+                const std::lock_guard lock(error_mutex);
+                if (error) {
+                    continue;
+                }
+            }
+
+            try {
+                const size2_t first = size2_t(bi, bj) * block;
+                const std::size_t end_i = std::min(first[0] + block[0], size[0]);
+                const std::size_t end_j = std::min(first[1] + block[1], size[1]);
+
+                for (std::size_t j = first[1]; j < end_j; j++) {
+                    for (std::size_t i = first[0]; i < end_i; i++) {
+                        f(size2_t(i, j));
+                    }
+                }
+            } catch (...) {
+                // exceptions must not leave the parallel region
+                const std::lock_guard lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+
+// ---------------------- implementation ----------------------
+
+inline GridGeometry::GridGeometry(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size, bool periodic)
+    : aabb(aabb), grid_size(grid_size), cell_size((aabb.max - aabb.min) / (grid_size - vec2_t(1))),
+      period(periodic ? cell_size[0] * grid_size[0] : 0) {
+
+    if (grid_size[0] <= 1 || grid_size[1] <= 1) {
+        throw std::runtime_error("grid size must be at least 2x2");
+    }
+}
+
+inline vec2_t GridGeometry::wrapPoint(const vec2_t& point) const {
+    if (period == 0) {
+        return point;
+    }
+
+    vec2_t p = point;
+    p[0] = std::fmod(p[0] - aabb.min[0], period);
+    if (p[0] < 0) {
+        p[0] += period;
+    }
+    p[0] += aabb.min[0];
+
+    return p;
+}
+
+inline std::size_t GridGeometry::linearIndex(const size2_t& idx) const {
+    assert(idx[0] < grid_size[0] && idx[1] < grid_size[1]);
+
+    return idx[0] + idx[1] * grid_size[0];
+}
+
+inline size2_t GridGeometry::gridIndex(std::size_t linear_idx) const {
+    assert(linear_idx < grid_size[0] * grid_size[1]);
+
+    return {linear_idx % grid_size[0], linear_idx / grid_size[0]};
+}
+
+inline size2_t GridGeometry::getSurroundingCell(const vec2_t& point, vec2_t& min, vec2_t& max) const {
+
+    // periodic fields extend to the next period in x direction
+    const real_t max_x = period != 0 ? aabb.min[0] + period : aabb.max[0];
+
+    if (point[0] < aabb.min[0] || point[1] < aabb.min[1] || point[0] > max_x || point[1] > aabb.max[1]) {
+        throw std::runtime_error("Trying to access scalar field out of bounds");
+    }
+
+    // calculate min index including border case
+    size2_t min_idx = toSize2((point - aabb.min) / cell_size);
+    if (period == 0 && min_idx[0] == grid_size[0] - 1) {
+        min_idx[0]--;
+    } else if (min_idx[0] >= grid_size[0]) {
+        min_idx[0] = grid_size[0] - 1;  // rounding at the end of the period
+    }
+    if (min_idx[1] == grid_size[1] - 1) {
+        min_idx[1]--;
+    }
+
+    min = aabb.min + toVec2(min_idx) * cell_size;
+    max = min + cell_size;
+
+    return min_idx;
+}
+
+template<typename S, typename Get>
+inline S GridGeometry::interpolate(const vec2_t& point, Get get) const {
+    const vec2_t p = wrapPoint(point);
+
+    vec2_t min_corner(0), max_corner(0);
+    const size2_t min_idx = getSurroundingCell(p, min_corner, max_corner);
+    const std::size_t x1 = nextColumn(min_idx[0]);
+
+    const S f11 = static_cast<S>(get(min_idx));
+    const S f12 = static_cast<S>(get(size2_t(min_idx[0], min_idx[1] + 1)));
+    const S f21 = static_cast<S>(get(size2_t(x1, min_idx[1])));
+    const S f22 = static_cast<S>(get(size2_t(x1, min_idx[1] + 1)));
+
+    const vec2_t factor = (p - min_corner) / (max_corner - min_corner);
+
+    return bilinearInterpolation(f11, f12, f21, f22, factor);
+}
+
+template<typename Get>
+inline vec2_t GridGeometry::gradientStencil(const size2_t& idx, Get get) const {
+    vec2_t distance(0);
+
+    // check if backward difference is possible
+    size2_t min_idx = idx;
+    for (int i = 0; i < 2; i++) {
+        if (min_idx[i] > 0) {
+            min_idx[i]--;
+            distance[i] += cell_size[i];
+        }
+    }
+
+    // check if forward difference is possible
+    size2_t max_idx = idx;
+    for (int i = 0; i < 2; i++) {
+        if (max_idx[i] < grid_size[i] - 1) {
+            max_idx[i]++;
+            distance[i] += cell_size[i];
+        }
+    }
+
+    // periodic fields always use central differences in x direction
+    if (period != 0) {
+        if (idx[0] == 0) {
+            min_idx[0] = grid_size[0] - 1;
+            distance[0] += cell_size[0];
+        }
+        if (idx[0] == grid_size[0] - 1) {
+            max_idx[0] = 0;
+            distance[0] += cell_size[0];
+        }
+    }
+
+    const auto f_min_x = get(size2_t(min_idx[0], idx[1]));
+    const auto f_max_x = get(size2_t(max_idx[0], idx[1]));
+    const auto f_min_y = get(size2_t(idx[0], min_idx[1]));
+    const auto f_max_y = get(size2_t(idx[0], max_idx[1]));
+
+    assert(distance[0] != 0 && distance[1] != 0);
+
+    vec2_t grad(0);
+    grad[0] = static_cast<real_t>(f_max_x - f_min_x) / distance[0];
+    grad[1] = static_cast<real_t>(f_max_y - f_min_y) / distance[1];
+
+    return grad;
+}
+
+template<typename S>
+inline S GridGeometry::bilinearInterpolation(const S& f11, const S& f12, const S& f21, const S& f22,
+                                             const vec2_t& factor) {
+
+    const S v0 = f11 * (1 - factor[0]) * (1 - factor[1]);
+    const S v1 = f12 * (1 - factor[0]) * factor[1];
+    const S v2 = f21 * factor[0] * (1 - factor[1]);
+    const S v3 = f22 * factor[0] * factor[1];
+
+    return v0 + v1 + v2 + v3;
+}
+
+}
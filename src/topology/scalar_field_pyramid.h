@@ -0,0 +1,246 @@
+#pragma once
+
+#include <topology/scalar_field.h>
+
+namespace omg {
+
+enum class Reduction {
+    MIN, MAX, MEAN
+};
+
+// multi-resolution levels of a scalar field, every level halves the resolution of the previous one
+// min and max levels are conservative: the min (max) of the corners of a coarse cell is a lower (upper) bound
+// for all values of the base field inside this cell
+// only the coarser levels are copies, level 0 references the field, which must outlive the pyramid
+template<typename T>
+class ScalarFieldPyramid {
+public:
+    explicit ScalarFieldPyramid(const ScalarField<T>& field);
+
+    // level 0 is the base field
+    inline std::size_t numLevels() const { return min_levels.size() + 1; }
+
+    const ScalarField<T>& getLevel(std::size_t level, Reduction reduction) const;
+
+    // select the coarsest level with a cell size not larger than the footprint
+    std::size_t selectLevel(real_t footprint) const;
+
+    // interpolated value on the level selected by the footprint
+    template<typename Type = DefaultType,
+             typename S = typename std::conditional<std::is_same<Type, DefaultType>::value, T, Type>::type>
+    S getValue(const vec2_t& point, real_t footprint, Reduction reduction = Reduction::MEAN) const;
+
+    // conservative bounds of all values inside the box, the level is selected by the box size
+    T getMin(const AxisAlignedBoundingBox& box) const;
+    T getMax(const AxisAlignedBoundingBox& box) const;
+
+private:
+    const ScalarField<T>& base;  // not owned
+
+    std::vector<ScalarField<T>> min_levels;
+    std::vector<ScalarField<T>> max_levels;
+    std::vector<ScalarField<T>> mean_levels;
+
+    static ScalarField<T> reduce(const ScalarField<T>& fine, Reduction reduction);
+
+    template<typename Compare>
+    T getBound(const AxisAlignedBoundingBox& box, Reduction reduction, Compare compare) const;
+};
+
+
+// ---------------------- implementation ----------------------
+
+template<typename T>
+ScalarFieldPyramid<T>::ScalarFieldPyramid(const ScalarField<T>& field) : base(field) {
+
+    // reduce until the grid cannot get smaller
+    while (true) {
+        const ScalarField<T>& min_prev = min_levels.empty() ? base : min_levels.back();
+        const ScalarField<T>& max_prev = max_levels.empty() ? base : max_levels.back();
+        const ScalarField<T>& mean_prev = mean_levels.empty() ? base : mean_levels.back();
+
+        const size2_t& grid_size = min_prev.getGridSize();
+        if (grid_size[0] <= 2 && grid_size[1] <= 2) {
+            break;
+        }
+
+        min_levels.push_back(reduce(min_prev, Reduction::MIN));
+        max_levels.push_back(reduce(max_prev, Reduction::MAX));
+        mean_levels.push_back(reduce(mean_prev, Reduction::MEAN));
+    }
+}
+
+template<typename T>
+const ScalarField<T>& ScalarFieldPyramid<T>::getLevel(std::size_t level, Reduction reduction) const {
+    if (level >= numLevels()) {
+        throw std::runtime_error("Invalid pyramid level");
+    }
+    if (level == 0) {
+        return base;
+    }
+
+    switch (reduction) {
+        case Reduction::MIN:
+            return min_levels[level - 1];
+        case Reduction::MAX:
+            return max_levels[level - 1];
+        default:
+            return mean_levels[level - 1];
+    }
+}
+
+template<typename T>
+std::size_t ScalarFieldPyramid<T>::selectLevel(real_t footprint) const {
+    std::size_t level = 0;
+
+    for (std::size_t i = 0; i < min_levels.size(); i++) {
+        const vec2_t& cell_size = min_levels[i].getCellSize();
+
+        if (std::max(cell_size[0], cell_size[1]) > footprint) {
+            break;
+        }
+        level = i + 1;
+    }
+    return level;
+}
+
+template<typename T>
+template<typename Type, typename S>
+S ScalarFieldPyramid<T>::getValue(const vec2_t& point, real_t footprint, Reduction reduction) const {
+    return getLevel(selectLevel(footprint), reduction).template getValue<Type, S>(point);
+}
+
+template<typename T>
+T ScalarFieldPyramid<T>::getMin(const AxisAlignedBoundingBox& box) const {
+    return getBound(box, Reduction::MIN, [](T a, T b) { return a < b; });
+}
+
+template<typename T>
+T ScalarFieldPyramid<T>::getMax(const AxisAlignedBoundingBox& box) const {
+    return getBound(box, Reduction::MAX, [](T a, T b) { return a > b; });
+}
+
+template<typename T>
+template<typename Compare>
+T ScalarFieldPyramid<T>::getBound(const AxisAlignedBoundingBox& box, Reduction reduction, Compare compare) const {
+    const AxisAlignedBoundingBox& aabb = base.getBoundingBox();
+
+    if (box.is_empty() || box.min[0] < aabb.min[0] || box.min[1] < aabb.min[1] ||
+                          box.max[0] > aabb.max[0] || box.max[1] > aabb.max[1]) {
+        throw std::runtime_error("Trying to access scalar field pyramid out of bounds");
+    }
+
+    // a level with cells of about the box size only needs a few samples
+    const vec2_t box_size = box.size();
+    const ScalarField<T>& level = getLevel(selectLevel(std::max(box_size[0], box_size[1])), reduction);
+
+    const vec2_t& cell_size = level.getCellSize();
+    const size2_t& grid_size = level.getGridSize();
+
+    // corners of all cells intersecting the box
+    const size2_t min_idx = toSize2((box.min - aabb.min) / cell_size);
+    size2_t max_idx = toSize2((box.max - aabb.min) / cell_size) + size2_t(1);
+    max_idx[0] = std::min(max_idx[0], grid_size[0] - 1);
+    max_idx[1] = std::min(max_idx[1], grid_size[1] - 1);
+
+    T bound = level.grid(min_idx);
+    for (std::size_t j = min_idx[1]; j <= max_idx[1]; j++) {
+        for (std::size_t i = min_idx[0]; i <= max_idx[0]; i++) {
+
+            const T v = level.grid(i, j);
+            if (compare(v, bound)) {
+                bound = v;
+            }
+        }
+    }
+    return bound;
+}
+
+template<typename T>
+ScalarField<T> ScalarFieldPyramid<T>::reduce(const ScalarField<T>& fine, Reduction reduction) {
+
+    const size2_t& fine_size = fine.getGridSize();
+    const vec2_t& fine_cell = fine.getCellSize();
+    const AxisAlignedBoundingBox& aabb = fine.getBoundingBox();
+
+    // half the number of cells, keep the bounding box
+    size2_t grid_size;
+    for (int i = 0; i < 2; i++) {
+        grid_size[i] = std::max<std::size_t>(fine_size[i] / 2 + 1, 2);
+        grid_size[i] = std::min(grid_size[i], fine_size[i]);
+    }
+
+    ScalarField<T> coarse(aabb, grid_size);
+    const vec2_t& cell_size = coarse.getCellSize();
+
+    // fine index range covered by a coarse sample, min and max use the complete neighboring cells
+    const vec2_t radius = reduction == Reduction::MEAN ? cell_size / 2 : cell_size;
+
+    auto fineRange = [&](std::size_t k, int dim, std::size_t& from, std::size_t& to) {
+        const real_t center = k * cell_size[dim];
+
+        const real_t low = std::max<real_t>((center - radius[dim]) / fine_cell[dim], 0);
+        const real_t high = std::min<real_t>((center + radius[dim]) / fine_cell[dim], fine_size[dim] - 1);
+
+        if (reduction == Reduction::MEAN) {
+            from = static_cast<std::size_t>(std::ceil(low));
+            to = static_cast<std::size_t>(std::floor(high));
+        } else {
+            // conservative rounding
+            from = static_cast<std::size_t>(std::floor(low));
+            to = static_cast<std::size_t>(std::ceil(high));
+        }
+
+        // use at least the closest sample
+        if (from > to) {
+            from = to = std::min(static_cast<std::size_t>(std::round(center / fine_cell[dim])), fine_size[dim] - 1);
+        }
+    };
+
+    #pragma omp parallel for
+    for (std::size_t j = 0; j < grid_size[1]; j++) {
+
+        std::size_t from_j, to_j;
+        fineRange(j, 1, from_j, to_j);
+
+        for (std::size_t i = 0; i < grid_size[0]; i++) {
+
+            std::size_t from_i, to_i;
+            fineRange(i, 0, from_i, to_i);
+
+            T min = fine.grid(from_i, from_j);
+            T max = min;
+            real_t sum = 0;
+
+            for (std::size_t fj = from_j; fj <= to_j; fj++) {
+                for (std::size_t fi = from_i; fi <= to_i; fi++) {
+
+                    const T v = fine.grid(fi, fj);
+                    min = std::min(min, v);
+                    max = std::max(max, v);
+                    sum += static_cast<real_t>(v);
+                }
+            }
+
+            switch (reduction) {
+                case Reduction::MIN:
+                    coarse.grid(i, j) = min;
+                    break;
+                case Reduction::MAX:
+                    coarse.grid(i, j) = max;
+                    break;
+                case Reduction::MEAN:
+                    {
+                        const real_t mean = sum / ((to_i - from_i + 1) * (to_j - from_j + 1));
+                        coarse.grid(i, j) = std::is_integral<T>::value ? static_cast<T>(std::round(mean))
+                                                                        : static_cast<T>(mean);
+                    }
+                    break;
+            }
+        }
+    }
+
+    return coarse;
+}
+
+}
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <topology/scalar_field.h>
+
+namespace omg {
+
+// location of one tile inside the complete grid
+struct TileInfo {
+    size2_t index;   // tile coordinates
+    size2_t origin;  // grid index of the first value
+    size2_t size;    // number of values, smaller than the tile size at the upper borders
+};
+
+// backing storage for the tiles of a TiledScalarField
+template<typename T>
+class TileSource {
+public:
+    virtual ~TileSource() {}
+
+    // read the values of the tile row-major into dst
+    virtual void readTile(const TileInfo& tile, T* dst) = 0;
+
+    // write the values of the tile back, only called for modified tiles
+    virtual void writeTile(const TileInfo& tile, const T* src) = 0;
+};
+
+
+// scalar field that keeps only a bounded number of fixed-size tiles in memory,
+// tiles are loaded on demand from a TileSource and written back when they were modified.
+// threads missing different tiles read them concurrently, the TileSource has to be thread-safe
+template<typename T>
+class TiledScalarField : public GridGeometry {
+private:
+    struct Tile {
+        TileInfo info;
+        std::vector<T> values;
+        std::atomic<bool> dirty;
+        std::atomic<uint64_t> last_access;  // value of the access clock, the oldest tiles are evicted first
+        std::shared_future<void> loaded;    // ready when the values were read
+    };
+
+public:
+    // keeps a tile loaded as long as the handle exists
+    class TileHandle {
+    public:
+        inline bool contains(const size2_t& idx) const {
+            return idx[0] >= tile->info.origin[0] && idx[1] >= tile->info.origin[1] &&
+                   idx[0] < tile->info.origin[0] + tile->info.size[0] &&
+                   idx[1] < tile->info.origin[1] + tile->info.size[1];
+        }
+
+        // access by global grid index, the index has to be inside this tile
+        inline T get(const size2_t& idx) const { return tile->values[localIndex(idx)]; }
+
+        inline void set(const size2_t& idx, T value) {
+            tile->values[localIndex(idx)] = value;
+            tile->dirty = true;
+        }
+
+        inline const TileInfo& getInfo() const { return tile->info; }
+
+    private:
+        explicit TileHandle(std::shared_ptr<Tile> tile) : tile(std::move(tile)) {}
+
+        std::shared_ptr<Tile> tile;
+
+        inline std::size_t localIndex(const size2_t& idx) const {
+            assert(contains(idx));
+            return (idx[0] - tile->info.origin[0]) + (idx[1] - tile->info.origin[1]) * tile->info.size[0];
+        }
+
+        friend class TiledScalarField;
+    };
+
+    // the bounding box aligns with the outermost sample points, same as ScalarField
+    // max_memory limits the memory used by loaded tiles in bytes
+    TiledScalarField(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size,
+                     std::unique_ptr<TileSource<T>> source, std::size_t tile_size = 256,
+                     std::size_t max_memory = std::size_t(256) << 20);
+
+    TiledScalarField(const TiledScalarField&) = delete;
+    TiledScalarField& operator=(const TiledScalarField&) = delete;
+
+    ~TiledScalarField();
+
+    // specify type only used for interpolation
+    template<typename Type = DefaultType,
+             typename S = typename std::conditional<std::is_same<Type, DefaultType>::value, T, Type>::type>
+    S getValue(const vec2_t& point) const;
+
+    vec2_t getGradient(const vec2_t& point) const;
+
+    vec2_t computeGradient(const size2_t& idx) const;
+
+    inline std::size_t getTileSize() const { return tile_size; }
+    inline const size2_t& getTileCount() const { return tile_count; }
+    inline std::size_t getMaxTiles() const { return max_tiles; }
+
+    // traversal order for parallel loops over the grid, tile by tile
+    inline size2_t getBlockSize() const { return size2_t(tile_size); }
+
+    // point access, repeated reads from the same tile by a thread do not lock
+    inline T grid(std::size_t i, std::size_t j) const { return grid(size2_t(i, j)); }
+    T grid(const size2_t& idx) const;
+    void setGrid(const size2_t& idx, T value);
+
+    // handle to the tile containing the grid index
+    TileHandle tile(const size2_t& idx) const;
+
+    // write all modified tiles back to the source
+    void flush();
+
+    std::size_t numLoadedTiles() const;
+
+private:
+    // last tile read by this thread, not kept alive so it can still be evicted
+    struct ThreadCache {
+        std::size_t field_id = 0;  // zero is never used as id
+        size2_t tile_idx;
+        std::weak_ptr<Tile> tile;
+    };
+
+    const std::size_t tile_size;
+    const size2_t tile_count;
+    const std::size_t max_tiles;
+
+    const std::size_t id;
+
+    std::unique_ptr<TileSource<T>> source;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<std::size_t, std::shared_ptr<Tile>> tiles;
+
+    // advanced by every tile lookup, hits in the thread caches only copy it to the tile
+    mutable std::atomic<uint64_t> access_clock;
+
+    std::shared_ptr<Tile> loadTile(const size2_t& idx) const;
+    void evict() const;
+    void writeBack(Tile& tile) const;
+
+    inline void touch(Tile& t) const {
+        const uint64_t now = access_clock.load(std::memory_order_relaxed);
+        if (t.last_access.load(std::memory_order_relaxed) != now) {
+            t.last_access.store(now, std::memory_order_relaxed);
+        }
+    }
+
+    static std::size_t validTileSize(std::size_t tile_size) {
+        if (tile_size == 0) {
+            throw std::runtime_error("tile size must not be zero");
+        }
+        return tile_size;
+    }
+
+    static std::size_t nextId() {
+        static std::atomic<std::size_t> counter(1);
+        return counter++;
+    }
+
+    static ThreadCache& threadCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+};
+
+
+// ---------------------- implementation ----------------------
+
+template<typename T>
+TiledScalarField<T>::TiledScalarField(const AxisAlignedBoundingBox& aabb, const size2_t& grid_size,
+                                      std::unique_ptr<TileSource<T>> source, std::size_t tile_size,
+                                      std::size_t max_memory)
+    : GridGeometry(aabb, grid_size),
+      tile_size(validTileSize(tile_size)), tile_count((grid_size + size2_t(this->tile_size - 1)) / this->tile_size),
+      // at least 4 tiles are needed for interpolation at tile corners
+      max_tiles(std::max<std::size_t>(max_memory / (this->tile_size * this->tile_size * sizeof(T)), 4)),
+      id(nextId()), source(std::move(source)), access_clock(0) {
+
+    if (this->source == nullptr) {
+        throw std::runtime_error("tile source must not be null");
+    }
+}
+
+template<typename T>
+TiledScalarField<T>::~TiledScalarField() {
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        std::cerr << "warning: could not write back tiles: " << e.what() << std::endl;
+    }
+}
+
+template<typename T>
+template<typename Type, typename S>
+S TiledScalarField<T>::getValue(const vec2_t& point) const {
+
+    // if a non floating point type is implicitly used, show a warning
+    static_assert(!std::is_same<Type, DefaultType>::value || std::is_floating_point<S>::value,
+                  "implicit non floating point interpolation used");
+
+    return interpolate<S>(point, [this](const size2_t& idx) { return grid(idx); });
+}
+
+template<typename T>
+vec2_t TiledScalarField<T>::getGradient(const vec2_t& point) const {
+
+    static_assert(std::is_convertible<T, real_t>::value, "gradient is only defined on scalar values");
+
+    return interpolate<vec2_t>(point, [this](const size2_t& idx) { return computeGradient(idx); });
+}
+
+template<typename T>
+vec2_t TiledScalarField<T>::computeGradient(const size2_t& idx) const {
+    return gradientStencil(idx, [this](const size2_t& i) { return grid(i); });
+}
+
+template<typename T>
+T TiledScalarField<T>::grid(const size2_t& idx) const {
+    if (idx[0] >= grid_size[0] || idx[1] >= grid_size[1]) {
+        throw std::runtime_error("Trying to access tiled scalar field out of bounds");
+    }
+
+    const size2_t tile_idx = idx / tile_size;
+    ThreadCache& cache = threadCache();
+
+    std::shared_ptr<Tile> t;
+    if (cache.field_id == id && cache.tile_idx == tile_idx) {
+        t = cache.tile.lock();
+    }
+    if (t) {
+        touch(*t);
+    } else {
+        t = loadTile(tile_idx);
+        cache.field_id = id;
+        cache.tile_idx = tile_idx;
+        cache.tile = t;
+    }
+
+    return TileHandle(std::move(t)).get(idx);
+}
+
+template<typename T>
+void TiledScalarField<T>::setGrid(const size2_t& idx, T value) {
+    tile(idx).set(idx, value);
+}
+
+template<typename T>
+typename TiledScalarField<T>::TileHandle TiledScalarField<T>::tile(const size2_t& idx) const {
+    if (idx[0] >= grid_size[0] || idx[1] >= grid_size[1]) {
+        throw std::runtime_error("Trying to access tiled scalar field out of bounds");
+    }
+    return TileHandle(loadTile(idx / tile_size));
+}
+
+template<typename T>
+void TiledScalarField<T>::flush() {
+    const std::lock_guard lock(mutex);
+
+    for (const auto& [key, t] : tiles) {
+        writeBack(*t);
+    }
+}
+
+template<typename T>
+std::size_t TiledScalarField<T>::numLoadedTiles() const {
+    const std::lock_guard lock(mutex);
+    return tiles.size();
+}
+
+template<typename T>
+std::shared_ptr<typename TiledScalarField<T>::Tile> TiledScalarField<T>::loadTile(const size2_t& idx) const {
+    const std::size_t key = idx[0] + idx[1] * tile_count[0];
+
+    std::shared_ptr<Tile> t;
+    std::promise<void> read;
+    bool found;
+
+    {
+        const std::lock_guard lock(mutex);
+        const uint64_t now = ++access_clock;
+
+        auto it = tiles.find(key);
+        found = it != tiles.end();
+
+        if (found) {
+            t = it->second;
+            t->last_access = now;
+
+        } else {
+            evict();
+
+            // placeholder, other threads missing the same tile wait until it is read
+            t = std::make_shared<Tile>();
+            t->info.index = idx;
+            t->info.origin = idx * tile_size;
+            t->info.size[0] = std::min(tile_size, grid_size[0] - t->info.origin[0]);
+            t->info.size[1] = std::min(tile_size, grid_size[1] - t->info.origin[1]);
+            t->values.resize(t->info.size[0] * t->info.size[1]);
+            t->dirty = false;
+            t->last_access = now;
+            t->loaded = read.get_future().share();
+
+            tiles.emplace(key, t);
+        }
+    }
+
+    if (found) {
+        t->loaded.get();  // rethrows the error of the reading thread
+        return t;
+    }
+
+    // read without holding the lock
+    try {
+        source->readTile(t->info, t->values.data());
+    } catch (...) {
+        {
+            const std::lock_guard lock(mutex);
+            tiles.erase(key);
+        }
+        read.set_exception(std::current_exception());
+        throw;
+    }
+    read.set_value();
+
+    return t;
+}
+
+template<typename T>
+void TiledScalarField<T>::evict() const {
+    // remove the least recently accessed tiles that are not referenced by a handle or a reading thread,
+    // modified tiles are written back before they can be read again (mutex has to be locked)
+
+    while (tiles.size() >= max_tiles) {
+
+        auto oldest = tiles.end();
+        for (auto it = tiles.begin(); it != tiles.end(); ++it) {
+            if (it->second.use_count() > 1) {
+                continue;  // still in use
+            }
+            if (oldest == tiles.end() || it->second->last_access < oldest->second->last_access) {
+                oldest = it;
+            }
+        }
+
+        if (oldest == tiles.end()) {
+            return;
+        }
+
+        writeBack(*oldest->second);
+        tiles.erase(oldest);
+    }
+}
+
+template<typename T>
+void TiledScalarField<T>::writeBack(Tile& t) const {
+    if (t.dirty.exchange(false)) {
+        source->writeTile(t.info, t.values.data());
+    }
+}
+
+using TiledBathymetryData = TiledScalarField<int16_t>;
+
+}
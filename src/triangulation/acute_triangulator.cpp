@@ -2,14 +2,64 @@
 #include "acute_triangulator.h"
 
 #include <triangle_api.h>
+#include <triangulation/interior_seeding.h>
 #include <triangulation/triangle_helper.h>
+#include <util.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace omg {
 
-const SizeFunction* ACuteTriangulator::size_function;
+thread_local const FastSizeQuery* ACuteTriangulator::size_query = nullptr;
+
+static std::size_t defaultMaxIdle() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+ACuteTriangulator::ContextPool::ContextPool(real_t min_angle, real_t max_angle, std::size_t max_idle,
+                                            std::size_t max_idle_triangles)
+    : min_angle(min_angle), max_angle(max_angle), max_idle(max_idle == 0 ? defaultMaxIdle() : max_idle),
+      max_idle_triangles(max_idle_triangles) {}
+
+ACuteTriangulator::ContextPool::~ContextPool() {
+    for (context* ctx : idle) {
+        triangle_context_destroy(ctx);
+    }
+}
+
+ACuteTriangulator::ContextPool::Lease ACuteTriangulator::ContextPool::acquire() {
+    {
+        const std::lock_guard lock(mutex);
+        if (!idle.empty()) {
+            context* ctx = idle.back();
+            idle.pop_back();
+            return Lease(*this, ctx);
+        }
+    }
+
+    // created outside of the lock, other threads can continue meanwhile
+    return Lease(*this, create());
+}
+
+void ACuteTriangulator::ContextPool::release(context* ctx, std::size_t mesh_triangles) {
+    if (mesh_triangles <= max_idle_triangles) {
+        const std::lock_guard lock(mutex);
+        if (idle.size() < max_idle) {
+            idle.push_back(ctx);
+            return;
+        }
+    }
+    triangle_context_destroy(ctx);
+}
 
-ACuteTriangulator::ACuteTriangulator(real_t min_angle, real_t max_angle) {
-    ctx = triangle_context_create();
+context* ACuteTriangulator::ContextPool::create() const {
+    context* ctx = triangle_context_create();
 
     behavior options;
     triangle_context_get_behavior(ctx, &options);
@@ -26,39 +76,85 @@ ACuteTriangulator::ACuteTriangulator(real_t min_angle, real_t max_angle) {
     options.minangle = min_angle;
     options.maxangle = max_angle;
 
-    check(triangle_context_set_behavior(ctx, &options));
+    const int status = triangle_context_set_behavior(ctx, &options);
+    if (status != TRI_OK) {
+        triangle_context_destroy(ctx);
+        check(status);
+    }
+    return ctx;
 }
 
-ACuteTriangulator::~ACuteTriangulator() {
-    triangle_context_destroy(ctx);
+ACuteTriangulator::ACuteTriangulator(real_t min_angle, real_t max_angle)
+    : ACuteTriangulator(std::make_shared<ContextPool>(min_angle, max_angle)) {}
+
+ACuteTriangulator::ACuteTriangulator(std::shared_ptr<ContextPool> pool) : pool(std::move(pool)) {
+
+    if (!this->pool) {
+        throw std::runtime_error("Context pool was null");
+    }
 }
 
-void ACuteTriangulator::generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary) {
-    size_function = &size;
+TriangulationStats ACuteTriangulator::generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary) {
+    const Stopwatch total;
+    TriangulationStats stats;
 
-    TriangleIn<triangleio> in(boundary);
+    const FastSizeQuery query(size);
+
+    std::vector<vec2_t> seeds;
+    if (interior_seeding) {
+        seeds = InteriorSeeder(size).generateSeeds(boundary);
+    }
+
+    TriangleIn<triangleio> in(boundary, seeds);
     TriangleOut<triangleio> out;
 
-    check(triangle_mesh_create(ctx, &in.io));
+    ContextPool::Lease ctx = pool->acquire();
+
+    // the size query is only installed while Triangle runs, also if it throws
+    struct SizeQueryScope {
+        explicit SizeQueryScope(const FastSizeQuery* query) { size_query = query; }
+        ~SizeQueryScope() { size_query = nullptr; }
+    };
+
+    const Stopwatch mesher;
+    {
+        const SizeQueryScope scope(&query);
+        check(triangle_mesh_create(ctx.get(), &in.io));
+    }
+    stats.mesher_time = mesher.elapsed();
 
-    check(triangle_mesh_copy(ctx, &out.io, false, false));
+    check(triangle_mesh_copy(ctx.get(), &out.io, false, false));
+    ctx.setMeshSize(out.io.numberoftriangles);
 
-    out.toMesh(out_mesh);
+    stats.size_query = query.getStatistics();
+    stats.input_points = in.io.numberofpoints;
+    stats.steiner_points = out.io.numberofpoints - in.io.numberofpoints;
+
+    out.toFlatMesh(out_mesh);
+    stats.peak_output_bytes = out.numBytes() + out_mesh.numBytes();
+
+    // seeds in holes are not part of a triangle
+    if (interior_seeding) {
+        out_mesh.removeUnusedPoints();
+    }
 
-    size_function = nullptr;
+    stats.num_vertices = out_mesh.numVertices();
+    stats.num_triangles = out_mesh.numTriangles();
+    stats.total_time = total.elapsed();
+    return stats;
 }
 
 int ACuteTriangulator::triunsuitable(double* v1, double* v2, double* v3, double area) {
     (void) area;  // unused
 
-    if (size_function == nullptr) {
-        throw std::runtime_error("size_function was null");
+    if (size_query == nullptr) {
+        throw std::runtime_error("size query was null");
     }
 
-    return !size_function->isTriangleGood(vec2_t(v1[0], v1[1]), vec2_t(v2[0], v2[1]), vec2_t(v3[0], v3[1]));
+    return !size_query->isTriangleGood(vec2_t(v1[0], v1[1]), vec2_t(v2[0], v2[1]), vec2_t(v3[0], v3[1]));
 }
 
-void ACuteTriangulator::check(int status_code) const {
+void ACuteTriangulator::check(int status_code) {
     std::string msg;
     switch (status_code) {
         case TRI_OK:
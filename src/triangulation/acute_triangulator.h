@@ -1,5 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <size_function/fast_size_query.h>
 #include <triangulation/triangulator.h>
 
 // context from triangle_api.h
@@ -8,19 +13,81 @@ typedef context_t context;
 
 namespace omg {
 
+// every triangulation checks out a context from a pool, so one instance can generate meshes concurrently
+// on different threads, e.g. for many small regions
 class ACuteTriangulator : public Triangulator {
 public:
+    // thread safe pool of contexts that are configured once, contexts are created on demand
+    // and reused without any setup, triangle_mesh_create replaces the previous mesh of a context
+    // an idle context still holds its last mesh, the API cannot free it alone,
+    // so contexts with large meshes are destroyed instead of being parked
+    class ContextPool {
+    public:
+        // about 10 MB of Triangle memory per idle context
+        static constexpr std::size_t DEFAULT_MAX_IDLE_TRIANGLES = std::size_t(1) << 16;
+
+        // max_idle = 0 keeps one context per OpenMP thread, further returned contexts are destroyed
+        explicit ContextPool(real_t min_angle = 25, real_t max_angle = 120, std::size_t max_idle = 0,
+                             std::size_t max_idle_triangles = DEFAULT_MAX_IDLE_TRIANGLES);
+        ~ContextPool();
+
+        ContextPool(const ContextPool&) = delete;
+        ContextPool& operator=(const ContextPool&) = delete;
+
+        // returns the context to the pool when destroyed
+        class Lease {
+        public:
+            Lease(ContextPool& pool, context* ctx) : pool(pool), ctx(ctx) {}
+            ~Lease() { pool.release(ctx, mesh_triangles); }
+
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+
+            inline context* get() const { return ctx; }
+
+            // size of the mesh left in the context, unknown sizes count as large
+            inline void setMeshSize(std::size_t num_triangles) { mesh_triangles = num_triangles; }
+
+        private:
+            ContextPool& pool;
+            context* const ctx;
+            std::size_t mesh_triangles = static_cast<std::size_t>(-1);
+        };
+
+        Lease acquire();
+
+    private:
+        const real_t min_angle;
+        const real_t max_angle;
+        const std::size_t max_idle;
+        const std::size_t max_idle_triangles;
+
+        std::mutex mutex;
+        std::vector<context*> idle;
+
+        context* create() const;
+        void release(context* ctx, std::size_t mesh_triangles);
+    };
+
     explicit ACuteTriangulator(real_t min_angle = 25, real_t max_angle = 120);
-    ~ACuteTriangulator();
 
-    void generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary = true) override;
+    // the pool can be shared by several triangulators with the same angles
+    explicit ACuteTriangulator(std::shared_ptr<ContextPool> pool);
+
+    // start from a lattice of points inside the domain, see InteriorSeeder
+    inline void setInteriorSeeding(bool enable) { interior_seeding = enable; }
+
+    TriangulationStats generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary = true) override;
 
 private:
-    static const SizeFunction* size_function;
+    // the C API has no user data for the callback, the size query of the running triangulation is kept per thread
+    static thread_local const FastSizeQuery* size_query;
+
+    const std::shared_ptr<ContextPool> pool;
 
-    context* ctx;
+    bool interior_seeding = false;
 
-    void check(int status_code) const;
+    static void check(int status_code);
 
     static int triunsuitable(double* v1, double* v2, double* v3, double area);
 };
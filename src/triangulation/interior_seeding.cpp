@@ -0,0 +1,306 @@
+
+#include "interior_seeding.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace omg {
+
+static const real_t MAX_SIZE_RATIO = 1.5;  // a lattice is only placed where the size is nearly constant
+static const std::size_t MAX_LATTICE_SIZE = 16;  // points along one side of a lattice
+static const int MAX_DEPTH = 40;
+static const std::size_t NODES_PER_THREAD = 64;  // quadtree nodes created before the subtrees are seeded in parallel
+
+struct OutlineSegment {
+    vec2_t a, b;
+};
+
+static inline real_t orientation(const vec2_t& a, const vec2_t& b, const vec2_t& c) {
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+// points on a line count as being on its right side, so the parity of the crossings along a path is consistent
+static inline bool crosses(const vec2_t& p, const vec2_t& q, const OutlineSegment& s) {
+    if ((orientation(p, q, s.a) > 0) == (orientation(p, q, s.b) > 0)) {
+        return false;
+    }
+    return (orientation(s.a, s.b, p) > 0) != (orientation(s.a, s.b, q) > 0);
+}
+
+// conservative, may report segments that only come close to the box
+static bool touches(const AxisAlignedBoundingBox& box, const OutlineSegment& s) {
+    if (std::max(s.a[0], s.b[0]) < box.min[0] || std::min(s.a[0], s.b[0]) > box.max[0] ||
+        std::max(s.a[1], s.b[1]) < box.min[1] || std::min(s.a[1], s.b[1]) > box.max[1]) {
+        return false;
+    }
+
+    const std::array<vec2_t, 4> corners = {box.min, vec2_t(box.max[0], box.min[1]),
+                                           box.max, vec2_t(box.min[0], box.max[1])};
+    bool left = false, right = false;
+    for (const vec2_t& c : corners) {
+        const real_t o = orientation(s.a, s.b, c);
+        left |= o >= 0;
+        right |= o <= 0;
+    }
+    return left && right;
+}
+
+struct QuadNode {
+    vec2_t min;
+    real_t width;
+    int depth;
+    bool inside;  // the center is inside the domain
+    std::vector<uint32_t> segments;  // all segments touching the node
+
+    inline vec2_t center() const { return min + vec2_t(width / 2); }
+    inline AxisAlignedBoundingBox box() const { return {min, min + vec2_t(width)}; }
+};
+
+class Seeder {
+public:
+    Seeder(const std::vector<OutlineSegment>& segments, const ScalarFieldPyramid<real_t>& pyramid, real_t spacing)
+        : segments(segments), pyramid(pyramid), spacing(spacing) {}
+
+    enum class Action {
+        SKIP, SEED, SUBDIVIDE
+    };
+
+    Action classify(const QuadNode& node) const;
+    std::array<QuadNode, 4> subdivide(const QuadNode& node) const;
+    void seed(const QuadNode& node, std::vector<vec2_t>& points) const;
+
+    void refine(const QuadNode& node, std::vector<vec2_t>& points) const;
+
+private:
+    const std::vector<OutlineSegment>& segments;
+    const ScalarFieldPyramid<real_t>& pyramid;
+    const real_t spacing;
+
+    // the pyramid only covers the size function, false if the node is completely outside
+    bool clampToSize(const QuadNode& node, AxisAlignedBoundingBox& box) const;
+
+    // smallest size in the node, 0 outside of the size function
+    real_t minSize(const QuadNode& node) const;
+    real_t maxSize(const QuadNode& node) const;
+};
+
+bool Seeder::clampToSize(const QuadNode& node, AxisAlignedBoundingBox& box) const {
+    const AxisAlignedBoundingBox& aabb = pyramid.getLevel(0, Reduction::MIN).getBoundingBox();
+    box = node.box();
+
+    box.min[0] = std::max(box.min[0], aabb.min[0]);
+    box.min[1] = std::max(box.min[1], aabb.min[1]);
+    box.max[0] = std::min(box.max[0], aabb.max[0]);
+    box.max[1] = std::min(box.max[1], aabb.max[1]);
+
+    return box.min[0] <= box.max[0] && box.min[1] <= box.max[1];
+}
+
+real_t Seeder::minSize(const QuadNode& node) const {
+    AxisAlignedBoundingBox box;
+    return clampToSize(node, box) ? pyramid.getMin(box) : 0;
+}
+
+real_t Seeder::maxSize(const QuadNode& node) const {
+    AxisAlignedBoundingBox box;
+    return clampToSize(node, box) ? pyramid.getMax(box) : 0;
+}
+
+Seeder::Action Seeder::classify(const QuadNode& node) const {
+    const real_t min_size = minSize(node);
+
+    // no points where the size is invalid
+    if (min_size <= 0 || node.depth >= MAX_DEPTH) {
+        return Action::SKIP;
+    }
+
+    const real_t distance = spacing * min_size;
+
+    // cells crossed by the outline are refined down to the point distance to keep the seeds away from it
+    if (!node.segments.empty()) {
+        return node.width <= distance ? Action::SKIP : Action::SUBDIVIDE;
+    }
+
+    if (!node.inside) {
+        return Action::SKIP;
+    }
+
+    if (node.width <= distance
+        || (node.width <= MAX_LATTICE_SIZE * distance && maxSize(node) <= MAX_SIZE_RATIO * min_size)) {
+        return Action::SEED;
+    }
+    return Action::SUBDIVIDE;
+}
+
+std::array<QuadNode, 4> Seeder::subdivide(const QuadNode& node) const {
+    std::array<QuadNode, 4> children;
+
+    const vec2_t center = node.center();
+    const real_t width = node.width / 2;
+
+    for (std::size_t k = 0; k < 4; k++) {
+        QuadNode& child = children[k];
+        child.min = node.min + vec2_t(static_cast<real_t>(k % 2), static_cast<real_t>(k / 2)) * width;
+        child.width = width;
+        child.depth = node.depth + 1;
+
+        // the path between the centers lies in the node, only its segments can cross it
+        const vec2_t child_center = child.center();
+        const AxisAlignedBoundingBox child_box = child.box();
+
+        bool inside = node.inside;
+        for (uint32_t s : node.segments) {
+            if (crosses(center, child_center, segments[s])) {
+                inside = !inside;
+            }
+            if (touches(child_box, segments[s])) {
+                child.segments.push_back(s);
+            }
+        }
+        child.inside = inside;
+    }
+    return children;
+}
+
+void Seeder::seed(const QuadNode& node, std::vector<vec2_t>& points) const {
+    const AxisAlignedBoundingBox& aabb = pyramid.getLevel(0, Reduction::MEAN).getBoundingBox();
+    vec2_t center = node.center();
+    center[0] = std::clamp(center[0], aabb.min[0], aabb.max[0]);
+    center[1] = std::clamp(center[1], aabb.min[1], aabb.max[1]);
+
+    // the minimum would make the lattice too dense, Triangle can add missing points but never removes any
+    const real_t mean = pyramid.getValue(center, node.width);
+    const real_t distance = spacing * (mean > 0 ? mean : minSize(node));
+
+    // regular lattice with about the point distance, half a step away from the cell border,
+    // rounding leaves small cells at the outline empty instead of crowding them
+    const std::size_t n = static_cast<std::size_t>(std::round(node.width / distance));
+    if (n == 0) {
+        return;
+    }
+    const real_t step = node.width / static_cast<real_t>(n);
+
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t i = 0; i < n; i++) {
+            points.push_back(node.min + vec2_t((i + 0.5) * step, (j + 0.5) * step));
+        }
+    }
+}
+
+void Seeder::refine(const QuadNode& node, std::vector<vec2_t>& points) const {
+    switch (classify(node)) {
+        case Action::SEED:
+            seed(node, points);
+            break;
+        case Action::SUBDIVIDE:
+            for (const QuadNode& child : subdivide(node)) {
+                refine(child, points);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+InteriorSeeder::InteriorSeeder(const SizeFunction& size, real_t spacing) : pyramid(size), spacing(spacing) {
+    if (spacing <= 0) {
+        throw std::runtime_error("Seed spacing must be positive");
+    }
+}
+
+std::vector<vec2_t> InteriorSeeder::generateSeeds(const LineGraph& outline) const {
+    if (outline.numEdges() == 0) {
+        return {};
+    }
+
+    std::vector<OutlineSegment> segments(outline.numEdges());
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        const LineGraph::Edge& e = outline.getEdge(i);
+        segments[i] = {outline.getPoint(e.first), outline.getPoint(e.second)};
+    }
+
+    const Seeder seeder(segments, pyramid, spacing);
+
+    // square root cell around the outline
+    const AxisAlignedBoundingBox aabb = outline.computeBoundingBox();
+    const vec2_t extent = aabb.size();
+
+    QuadNode root;
+    root.width = std::max(extent[0], extent[1]);
+    root.min = aabb.min;
+    root.depth = 0;
+    root.segments.resize(segments.size());
+    std::iota(root.segments.begin(), root.segments.end(), 0);
+
+    // a point left of the root cell is outside
+    const vec2_t outside(root.min[0] - root.width, root.center()[1]);
+    root.inside = false;
+    for (const OutlineSegment& s : segments) {
+        if (crosses(outside, root.center(), s)) {
+            root.inside = !root.inside;
+        }
+    }
+
+#ifdef _OPENMP
+    const std::size_t num_threads = omp_get_max_threads();
+#else
+    const std::size_t num_threads = 1;
+#endif
+
+    // split the top of the tree breadth first until there is enough work for all threads,
+    // the order of the nodes and thus of the seeds is independent of the number of threads
+    std::vector<QuadNode> nodes = {root};
+    bool split = true;
+
+    while (split && nodes.size() < NODES_PER_THREAD * num_threads) {
+        split = false;
+
+        std::vector<QuadNode> next;
+        for (QuadNode& node : nodes) {
+            if (seeder.classify(node) == Seeder::Action::SUBDIVIDE) {
+                for (QuadNode& child : seeder.subdivide(node)) {
+                    next.push_back(std::move(child));
+                }
+                split = true;
+            } else {
+                next.push_back(std::move(node));
+            }
+        }
+        nodes = std::move(next);
+    }
+
+    std::vector<std::vector<vec2_t>> seeds(nodes.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        seeder.refine(nodes[i], seeds[i]);
+    }
+
+    std::size_t num_seeds = 0;
+    for (const std::vector<vec2_t>& s : seeds) {
+        num_seeds += s.size();
+    }
+
+    std::vector<vec2_t> result;
+    result.reserve(num_seeds);
+    for (const std::vector<vec2_t>& s : seeds) {
+        result.insert(result.end(), s.begin(), s.end());
+    }
+    return result;
+}
+
+std::vector<vec2_t> InteriorSeeder::generateSeeds(const Boundary& boundary) const {
+    std::vector<HEPolygon> polys = boundary.getIslands();
+    polys.push_back(boundary.getOuter());
+
+    return generateSeeds(LineGraph::combinePolygons(polys));
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include <boundary/boundary.h>
+#include <geometry/line_graph.h>
+#include <size_function/size_function.h>
+#include <topology/scalar_field_pyramid.h>
+
+namespace omg {
+
+// points inside the domain with a distance of about spacing times the size function,
+// the triangulators start from them and only have to refine the gaps instead of inserting every point on its own
+// the domain is split by a quadtree until the size is nearly constant in a cell, cells crossed by the outline
+// get no points, all others inside get a regular lattice
+class InteriorSeeder {
+public:
+    // the diagonals of the default lattice stay close to SizeFunction::MAX_SIZE_FACTOR
+    static constexpr real_t DEFAULT_SPACING = 0.9;
+
+    // keeps a reference to size through the pyramid, size must outlive the seeder
+    explicit InteriorSeeder(const SizeFunction& size, real_t spacing = DEFAULT_SPACING);
+
+    // the outline must consist of closed polygons, the seeds don't depend on the number of threads
+    std::vector<vec2_t> generateSeeds(const LineGraph& outline) const;
+
+    std::vector<vec2_t> generateSeeds(const Boundary& boundary) const;
+
+private:
+    const ScalarFieldPyramid<real_t> pyramid;
+    const real_t spacing;
+};
+
+}
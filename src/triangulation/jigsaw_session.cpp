@@ -0,0 +1,201 @@
+
+#include "jigsaw_session.h"
+
+#include <limits>
+
+#include <util.h>
+
+namespace omg {
+
+static void convertToMesh(const jigsaw_msh_t& jig_mesh, FlatMesh& out_mesh) {
+    out_mesh = FlatMesh(jig_mesh._vert2._size, jig_mesh._tria3._size);
+
+    // add points
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < jig_mesh._vert2._size; i++) {
+
+        const jigsaw_VERT2_t& vert = jig_mesh._vert2._data[i];
+
+        out_mesh.setPoint(i, {vert._ppos[0], vert._ppos[1]});
+    }
+
+    // add triangles
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < jig_mesh._tria3._size; i++) {
+
+        const auto& tri = jig_mesh._tria3._data[i];
+
+        out_mesh.setTriangle(i, tri._node[0], tri._node[1], tri._node[2]);
+    }
+}
+
+JigsawSession::JigsawSession() : has_boundary(false), size_max(0) {
+    jigsaw_init_jig_t(&jig);
+
+    jig._verbosity = 1;
+    jig._mesh_dims = 2;
+
+    jigsaw_init_msh_t(&coast);
+}
+
+// true if the polygons consist of the same points as the stored ones
+static bool samePolygons(const std::vector<HEPolygon>& polys, const std::vector<vec2_t>& points,
+                         const std::vector<std::size_t>& sizes) {
+    if (polys.size() != sizes.size()) {
+        return false;
+    }
+
+    std::size_t i = 0;
+    for (std::size_t p = 0; p < polys.size(); p++) {
+        if (polys[p].numVertices() != sizes[p]) {
+            return false;
+        }
+
+        for (HEPolygon::VertexHandle vh : polys[p].vertices()) {
+            if (polys[p].point(vh) != points[i++]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool JigsawSession::setBoundary(const Boundary& boundary) {
+    const HEPolygon& outer = boundary.getOuter();
+
+    std::vector<HEPolygon> polys = boundary.getIslands();
+    polys.push_back(outer);
+
+    if (has_boundary && samePolygons(polys, boundary_points, polygon_sizes)) {
+        return false;
+    }
+
+    // forget the previous boundary in case the conversion throws
+    has_boundary = false;
+    boundary_points.clear();
+    polygon_sizes.clear();
+
+    omg::LineGraph outline = LineGraph::combinePolygons(polys);
+
+    if (outline.numVertices() > static_cast<std::size_t>(std::numeric_limits<indx_t>::max())) {
+        throw std::runtime_error("Too many vertices in outline");
+    }
+    if (outline.numEdges() > static_cast<std::size_t>(std::numeric_limits<indx_t>::max())) {
+        throw std::runtime_error("Too many edges in outline");
+    }
+
+    // copy vertices, the capacity of the previous boundary is kept
+    vertices.clear();
+    vertices.reserve(outline.numVertices());
+
+    for (const vec2_t& p : outline.getPoints()) {
+        vertices.push_back({{p[0], p[1]}, 0});
+    }
+
+    // copy edges
+    edges.clear();
+    edges.reserve(outline.numEdges());
+
+    for (const LineGraph::Edge& e : outline.getEdges()) {
+
+        const indx_t v0 = e.first;
+        const indx_t v1 = e.second;
+        edges.push_back({{v0, v1}, 0});
+    }
+
+    // create bounds
+    bounds.clear();
+    bounds.reserve(outer.numHalfEdges());
+
+    for (std::size_t i = 0; i < outer.numHalfEdges(); i++) {
+
+        indx_t idx = outline.numEdges() - i - 1;
+        bounds.push_back({0, idx, JIGSAW_EDGE2_TAG});
+    }
+
+    coast._flags = JIGSAW_EUCLIDEAN_MESH;
+
+    coast._vert2._data = vertices.data();
+    coast._vert2._size = vertices.size();
+
+    coast._edge2._data = edges.data();
+    coast._edge2._size = edges.size();
+
+    // TODO: is this needed?
+    // coast._bound._data = bounds.data();
+    // coast._bound._size = bounds.size();
+
+    for (const HEPolygon& poly : polys) {
+        polygon_sizes.push_back(poly.numVertices());
+
+        for (HEPolygon::VertexHandle vh : poly.vertices()) {
+            boundary_points.push_back(poly.point(vh));
+        }
+    }
+
+    has_boundary = true;
+    return true;
+}
+
+bool JigsawSession::setSizeFunction(const SizeFunction& size) {
+    if (size.getMax() == 0) {
+        throw std::runtime_error("size function maximum is zero");
+    }
+
+    bool changed = true;
+    if (h_fun && h_fun->hasSameGrid(size)) {
+        changed = h_fun->update(size) || size_max != size.getMax();
+    } else {
+        h_fun = std::make_unique<JigsawSizeFunction>(size);
+    }
+    size_max = size.getMax();
+    return changed;
+}
+
+TriangulationStats JigsawSession::generateFlatMesh(FlatMesh& out_mesh) {
+    ScopeTimer timer("Jigsaw generate mesh");
+    const Stopwatch total;
+    TriangulationStats stats;
+
+    if (!has_boundary) {
+        throw std::runtime_error("No boundary set for jigsaw");
+    }
+    if (!h_fun) {
+        throw std::runtime_error("No size function set for jigsaw");
+    }
+
+    jig._hfun_hmax = size_max;
+    jig._hfun_hmin = 0;
+    jig._hfun_scal = JIGSAW_HFUN_ABSOLUTE;
+
+    jigsaw_msh_t mesh;
+    jigsaw_init_msh_t(&mesh);
+
+    const Stopwatch mesher;
+    int retv = jigsaw(&jig, &coast, NULL, &h_fun->getJigsawMesh(), &mesh);
+    stats.mesher_time = mesher.elapsed();
+
+    if (retv != 0) {
+        throw std::runtime_error("jigsaw error " + std::to_string(retv));
+    }
+
+    // jigsaw may move or drop boundary points, the difference is only an estimate
+    stats.input_points = vertices.size();
+    stats.steiner_points = mesh._vert2._size > vertices.size() ? mesh._vert2._size - vertices.size() : 0;
+
+    convertToMesh(mesh, out_mesh);
+    stats.peak_output_bytes = mesh._vert2._size * sizeof(jigsaw_VERT2_t) + mesh._tria3._size * sizeof(jigsaw_TRIA3_t)
+                            + out_mesh.numBytes();
+
+    jigsaw_free_msh_t(&mesh);
+
+    // also removes unused vertices
+    out_mesh.removeSeparatedSubmeshes();
+
+    stats.num_vertices = out_mesh.numVertices();
+    stats.num_triangles = out_mesh.numTriangles();
+    stats.total_time = total.elapsed();
+    return stats;
+}
+
+}
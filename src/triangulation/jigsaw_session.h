@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <boundary/boundary.h>
+#include <mesh/flat_mesh.h>
+#include <size_function/jigsaw_size.h>
+#include <triangulation/triangulation_stats.h>
+
+#include <jigsaw/inc/lib_jigsaw.h>
+
+namespace omg {
+
+// keeps the converted boundary and size function between JIGSAW runs, for sweeps over options or inputs
+// inputs equal to the previous ones are detected and not converted again, the buffers are reused
+// not thread safe, use one session per thread
+class JigsawSession {
+public:
+    JigsawSession();
+
+    // persists between runs, the size function settings are overwritten by generateFlatMesh
+    inline jigsaw_jig_t& getOptions() { return jig; }
+
+    // returns false if the polygons are the same as before, the outline is only rebuilt if they changed
+    bool setBoundary(const Boundary& boundary);
+
+    // a size function on the same grid as the previous one only updates the changed values,
+    // returns false if there were none
+    bool setSizeFunction(const SizeFunction& size);
+
+    // both boundary and size function must be set
+    TriangulationStats generateFlatMesh(FlatMesh& out_mesh);
+
+private:
+    jigsaw_jig_t jig;
+
+    // jigsaw only references the buffers
+    jigsaw_msh_t coast;
+    std::vector<jigsaw_VERT2_t> vertices;
+    std::vector<jigsaw_EDGE2_t> edges;
+    std::vector<jigsaw_BOUND_t> bounds;
+    bool has_boundary;
+
+    // points of all polygons of the converted boundary, islands first, to detect unchanged boundaries
+    std::vector<vec2_t> boundary_points;
+    std::vector<std::size_t> polygon_sizes;
+
+    std::unique_ptr<JigsawSizeFunction> h_fun;
+    real_t size_max;
+};
+
+}
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <triangulation/jigsaw_session.h>
 #include <triangulation/triangulator.h>
 
 namespace omg {
 
+// the session keeps the converted inputs, a triangulation with the same boundary or size function
+// as the previous one skips their conversion, so sweeps over the options only run JIGSAW
 class JigsawTriangulator : public Triangulator {
 public:
     JigsawTriangulator();
 
-    void generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary = true) override;
+    // options for the following triangulations
+    inline jigsaw_jig_t& getOptions() { return session.getOptions(); }
+
+    TriangulationStats generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary = true) override;
+
+private:
+    JigsawSession session;
 };
 
 }
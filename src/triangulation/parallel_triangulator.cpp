@@ -0,0 +1,420 @@
+
+#include "parallel_triangulator.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+
+#include <Triangle/jrs_triangle.h>
+#include <triangulation/interior_seeding.h>
+#include <triangulation/triangle_helper.h>
+#include <triangulation/triangle_triangulator.h>
+#include <util.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace omg {
+
+// boundary and interface segments of all strips, the points are shared between the strips
+struct Decomposition {
+    std::vector<vec2_t> points;
+    std::vector<std::vector<LineGraph::Edge>> segments;  // per strip
+    std::vector<std::vector<vec2_t>> holes;  // per strip
+
+    inline std::size_t addPoint(const vec2_t& p) {
+        points.push_back(p);
+        return points.size() - 1;
+    }
+};
+
+// point where a boundary edge crosses a cut line
+struct Crossing {
+    real_t y;
+    std::size_t point;
+};
+
+// strip s lies between cuts[s - 1] and cuts[s]
+static inline std::size_t stripIndex(const std::vector<real_t>& cuts, real_t x) {
+    return std::upper_bound(cuts.begin(), cuts.end(), x) - cuts.begin();
+}
+
+static int triunsuitable(double* v1, double* v2, double* v3, double area, void* user_data) {
+    (void) area;  // unused
+
+    const FastSizeQuery* query = static_cast<const FastSizeQuery*>(user_data);
+    return !query->isTriangleGood(vec2_t(v1[0], v1[1]), vec2_t(v2[0], v2[1]), vec2_t(v3[0], v3[1]));
+}
+
+// x positions that split the expected number of triangles evenly,
+// each cut is moved halfway between the closest boundary vertices to avoid tiny segments
+static std::vector<real_t> chooseCuts(const std::vector<HEPolygon>& polys, const SizeFunction& size,
+                                      std::size_t num_strips) {
+
+    std::vector<real_t> vertex_x;
+    for (const HEPolygon& poly : polys) {
+        for (HEPolygon::VertexHandle vh : poly.vertices()) {
+            vertex_x.push_back(poly.point(vh)[0]);
+        }
+    }
+    std::sort(vertex_x.begin(), vertex_x.end());
+
+    if (num_strips < 2 || vertex_x.size() < 2) {
+        return {};
+    }
+
+    // the number of triangles in a cell is proportional to the cell area divided by the squared size,
+    // land inside the bounding box is counted as well
+    const AxisAlignedBoundingBox aabb = polys.back().computeBoundingBox();
+    const size2_t& grid_size = size.getGridSize();
+
+    std::vector<real_t> work(grid_size[0] + 1, 0);
+
+    for (std::size_t j = 0; j < grid_size[1]; j++) {
+        const real_t y = size.getPoint(size2_t(0, j))[1];
+        if (y < aabb.min[1] || y > aabb.max[1]) {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < grid_size[0]; i++) {
+            const real_t x = size.getPoint(size2_t(i, j))[0];
+            const real_t s = size.grid(i, j);
+            if (x >= aabb.min[0] && x <= aabb.max[0] && s > 0) {
+                work[i + 1] += 1 / (s * s);
+            }
+        }
+    }
+    std::partial_sum(work.begin(), work.end(), work.begin());
+
+    std::vector<real_t> cuts;
+    for (std::size_t s = 1; s < num_strips; s++) {
+        real_t x;
+
+        if (work.back() > 0) {
+            const real_t target = work.back() * s / num_strips;
+            const std::size_t i = std::max<std::size_t>(std::lower_bound(work.begin(), work.end(), target) - work.begin(), 1);
+
+            const real_t fraction = (target - work[i - 1]) / std::max<real_t>(work[i] - work[i - 1], 1e-300);
+            x = size.getPoint(size2_t(i - 1, 0))[0] + fraction * size.getCellSize()[0];
+        } else {
+            x = vertex_x.front() + (vertex_x.back() - vertex_x.front()) * s / num_strips;
+        }
+
+        const auto next = std::upper_bound(vertex_x.begin(), vertex_x.end(), x);
+        if (next == vertex_x.begin() || next == vertex_x.end()) {
+            continue;  // no boundary on one side
+        }
+        cuts.push_back((*(next - 1) + *next) / 2);
+    }
+
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    return cuts;
+}
+
+static void addInterfaceSegment(Decomposition& d, std::size_t cut, std::size_t p0, std::size_t p1) {
+    // the cut is part of the boundary of both strips
+    d.segments[cut].push_back({p0, p1});
+    d.segments[cut + 1].push_back({p0, p1});
+}
+
+// points on the cut line between two crossings with the spacing given by the size function
+static void discretizeInterface(Decomposition& d, std::size_t cut, real_t x, const Crossing& from, const Crossing& to,
+                                const SizeFunction& size) {
+
+    // march with steps of the local size, then shrink the steps to end exactly at the second crossing
+    std::vector<real_t> steps = {from.y};
+    while (steps.back() < to.y) {
+        const real_t step = size.getValue(vec2_t(x, steps.back()));
+        if (!(step > 0)) {
+            throw std::runtime_error("Invalid size on cut line at x = " + std::to_string(x));
+        }
+        steps.push_back(steps.back() + step);
+    }
+    const real_t scale = (to.y - from.y) / (steps.back() - from.y);
+
+    std::size_t prev = from.point;
+    for (std::size_t k = 1; k + 1 < steps.size(); k++) {
+        const std::size_t p = d.addPoint(vec2_t(x, from.y + (steps[k] - from.y) * scale));
+        addInterfaceSegment(d, cut, prev, p);
+        prev = p;
+    }
+    addInterfaceSegment(d, cut, prev, to.point);
+}
+
+// split the boundary edges at the cuts and close every strip along the cut lines
+static Decomposition decompose(const std::vector<HEPolygon>& polys, const std::vector<real_t>& cuts,
+                               const SizeFunction& size) {
+
+    Decomposition d;
+    d.segments.resize(cuts.size() + 1);
+    d.holes.resize(cuts.size() + 1);
+
+    std::vector<std::vector<Crossing>> crossings(cuts.size());
+
+    for (const HEPolygon& poly : polys) {
+
+        std::vector<std::size_t> ring;
+        for (HEPolygon::VertexHandle vh : poly.verticesOrdered()) {
+            ring.push_back(d.addPoint(poly.point(vh)));
+        }
+
+        for (std::size_t k = 0; k < ring.size(); k++) {
+            const std::size_t a = ring[k];
+            const std::size_t b = ring[(k + 1) % ring.size()];
+            const vec2_t p = d.points[a];
+            const vec2_t q = d.points[b];
+
+            // cuts [first, last) are crossed, no vertex lies on a cut
+            const std::size_t first = stripIndex(cuts, std::min(p[0], q[0]));
+            const std::size_t last = stripIndex(cuts, std::max(p[0], q[0]));
+            const bool to_right = p[0] < q[0];
+
+            std::size_t prev = a;
+            for (std::size_t n = 0; n < last - first; n++) {
+                const std::size_t c = to_right ? first + n : last - 1 - n;
+
+                const real_t t = (cuts[c] - p[0]) / (q[0] - p[0]);
+                const vec2_t point(cuts[c], p[1] + t * (q[1] - p[1]));
+                const std::size_t crossing = d.addPoint(point);
+
+                crossings[c].push_back({point[1], crossing});
+
+                // the part before the crossing lies on the other side of the cut
+                d.segments[to_right ? c : c + 1].push_back({prev, crossing});
+                prev = crossing;
+            }
+            d.segments[stripIndex(cuts, q[0])].push_back({prev, b});
+        }
+    }
+
+    // islands inside one strip need a hole point, the others are connected
+    // to the outside of the strips and their triangles are removed by Triangle anyway
+    for (std::size_t i = 0; i + 1 < polys.size(); i++) {
+        const AxisAlignedBoundingBox aabb = polys[i].computeBoundingBox();
+        const std::size_t strip = stripIndex(cuts, aabb.min[0]);
+
+        if (strip == stripIndex(cuts, aabb.max[0])) {
+            d.holes[strip].push_back(polys[i].getPointInPolygon());
+        }
+    }
+
+    // the cut lines alternate between outside and inside of the domain at every crossing
+    for (std::size_t c = 0; c < cuts.size(); c++) {
+        std::vector<Crossing>& line = crossings[c];
+        std::sort(line.begin(), line.end(), [](const Crossing& c1, const Crossing& c2) { return c1.y < c2.y; });
+
+        if (line.size() % 2 != 0) {
+            throw std::runtime_error("Boundary is not closed");
+        }
+
+        for (std::size_t k = 0; k < line.size(); k += 2) {
+            if (line[k].y < line[k + 1].y) {  // touching polygons have no interior in between
+                discretizeInterface(d, c, cuts[c], line[k], line[k + 1], size);
+            }
+        }
+    }
+
+    return d;
+}
+
+static std::unique_ptr<TriangleOut<jrs::triangulateio>> triangulateStrip(const Decomposition& d, std::size_t strip,
+                                                                         const FastSizeQuery& query, real_t min_angle,
+                                                                         const InteriorSeeder* seeder,
+                                                                         std::vector<std::size_t>& points,
+                                                                         TriangulationStats& stats) {
+
+    const std::vector<LineGraph::Edge>& segments = d.segments[strip];
+    if (segments.empty()) {
+        return nullptr;
+    }
+
+    // shared indices of the points used by this strip, sorted to find the local index
+    for (const LineGraph::Edge& e : segments) {
+        points.push_back(e.first);
+        points.push_back(e.second);
+    }
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    const auto local = [&points](std::size_t p) {
+        return std::lower_bound(points.begin(), points.end(), p) - points.begin();
+    };
+
+    LineGraph outline;
+    outline.reserve(points.size(), segments.size());
+    for (std::size_t p : points) {
+        outline.addVertex(d.points[p]);
+    }
+    for (const LineGraph::Edge& e : segments) {
+        outline.addEdge(local(e.first), local(e.second));
+    }
+
+    // seeds of the strip keep their distance to the cut lines as well, they are new points like the Steiner points
+    std::vector<vec2_t> seeds;
+    if (seeder) {
+        seeds = seeder->generateSeeds(outline);
+    }
+
+    TriangleIn<jrs::triangulateio> in(outline, d.holes[strip], seeds);
+    auto out = std::make_unique<TriangleOut<jrs::triangulateio>>();
+
+    // same switches as TriangleTriangulator, but segments are never split
+    // to keep the interfaces of neighboring strips identical
+    TriangleArgs args;
+    args.quiet = true;
+    args.zero_based = true;
+    args.nobound = true;
+    args.nopolywritten = true;
+    args.user_test = true;
+    args.input_type = TriangleArgs::InputType::POLY;
+    args.conformdel = true;
+    args.quality = true;
+    args.min_angle = min_angle;
+    args.nobisect = true;
+
+    const Stopwatch mesher;
+    {
+        const jrs::TriunsuitableScope callback(triunsuitable, const_cast<FastSizeQuery*>(&query));
+        jrs::triangulate(args.toString(), &in.io, &out->io, nullptr);
+    }
+
+    stats.mesher_time = mesher.elapsed();
+    stats.input_points = in.io.numberofpoints;
+    stats.steiner_points = out->io.numberofpoints - in.io.numberofpoints;
+    stats.peak_output_bytes = out->numBytes();
+
+    if (out->io.numberofcorners != 3) {
+        throw std::runtime_error("Invalid number of corners");
+    }
+    return out;
+}
+
+
+ParallelTriangleTriangulator::ParallelTriangleTriangulator(real_t min_angle, std::size_t num_strips)
+    : min_angle(min_angle), num_strips(num_strips) {}
+
+TriangulationStats ParallelTriangleTriangulator::generateFlatMesh(const Boundary& boundary, const SizeFunction& size,
+                                                                  FlatMesh& out_mesh, bool keep_boundary) {
+    (void) keep_boundary;  // always kept
+
+    const Stopwatch total;
+
+    std::size_t strips = num_strips;
+    if (strips == 0) {
+#ifdef _OPENMP
+        strips = omp_get_max_threads();
+#else
+        strips = 1;
+#endif
+    }
+
+    std::vector<HEPolygon> polys = boundary.getIslands();
+    polys.push_back(boundary.getOuter());
+
+    const std::vector<real_t> cuts = chooseCuts(polys, size, strips);
+    const Decomposition d = decompose(polys, cuts, size);
+
+    const std::size_t num = d.segments.size();
+    std::vector<std::unique_ptr<TriangleOut<jrs::triangulateio>>> results(num);
+    std::vector<std::vector<std::size_t>> strip_points(num);
+    std::vector<TriangulationStats> strip_stats(num);
+
+    // shared by all strips
+    const FastSizeQuery query(size);
+    std::unique_ptr<InteriorSeeder> seeder;
+    if (interior_seeding) {
+        seeder = std::make_unique<InteriorSeeder>(size);
+    }
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (std::size_t s = 0; s < num; s++) {
+        try {
+            results[s] = triangulateStrip(d, s, query, min_angle, seeder.get(), strip_points[s], strip_stats[s]);
+
+        } catch (...) {
+            // exceptions must not leave the parallel region
+            const std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // the points on the cut lines are input of both strips, only the seeds are added per strip
+    TriangulationStats stats;
+    stats.size_query = query.getStatistics();
+    stats.input_points = d.points.size();
+    for (std::size_t s = 0; s < num; s++) {
+        if (results[s]) {
+            stats.input_points += strip_stats[s].input_points - strip_points[s].size();
+        }
+        stats.steiner_points += strip_stats[s].steiner_points;
+        stats.peak_output_bytes += strip_stats[s].peak_output_bytes;
+        stats.mesher_time += strip_stats[s].mesher_time;
+    }
+
+    // Triangle keeps the input points at their index and appends new points,
+    // only the new points of every strip need a new index
+    std::vector<std::size_t> offsets(num + 1, d.points.size());
+    std::vector<std::size_t> triangle_offsets(num + 1, 0);
+    for (std::size_t s = 0; s < num; s++) {
+        const std::size_t new_points = results[s] ? results[s]->io.numberofpoints - strip_points[s].size() : 0;
+        offsets[s + 1] = offsets[s] + new_points;
+        triangle_offsets[s + 1] = triangle_offsets[s] + (results[s] ? results[s]->io.numberoftriangles : 0);
+    }
+
+    out_mesh = FlatMesh(offsets.back(), triangle_offsets.back());
+
+    for (std::size_t i = 0; i < d.points.size(); i++) {
+        out_mesh.setPoint(i, d.points[i]);
+    }
+
+    // stitch the strips, the interface vertices are shared
+    #pragma omp parallel for schedule(dynamic)
+    for (std::size_t s = 0; s < num; s++) {
+        if (!results[s]) {
+            continue;
+        }
+        const jrs::triangulateio& io = results[s]->io;
+        const std::vector<std::size_t>& points = strip_points[s];
+
+        for (int i = static_cast<int>(points.size()); i < io.numberofpoints; i++) {
+            out_mesh.setPoint(offsets[s] + i - points.size(), {io.pointlist[2 * i + 0], io.pointlist[2 * i + 1]});
+        }
+
+        const auto shared = [&](int v) {
+            const std::size_t local = v;
+            return static_cast<int>(local < points.size() ? points[local] : offsets[s] + local - points.size());
+        };
+
+        for (int i = 0; i < io.numberoftriangles; i++) {
+            out_mesh.setTriangle(triangle_offsets[s] + i, shared(io.trianglelist[3 * i + 0]),
+                                 shared(io.trianglelist[3 * i + 1]), shared(io.trianglelist[3 * i + 2]));
+        }
+    }
+
+    stats.peak_output_bytes += out_mesh.numBytes();
+
+    // seeds in holes are not part of a triangle
+    if (interior_seeding) {
+        out_mesh.removeUnusedPoints();
+    }
+
+    stats.num_vertices = out_mesh.numVertices();
+    stats.num_triangles = out_mesh.numTriangles();
+    stats.total_time = total.elapsed();
+    return stats;
+}
+
+}
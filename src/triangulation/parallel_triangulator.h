@@ -0,0 +1,30 @@
+#pragma once
+
+#include <size_function/fast_size_query.h>
+#include <triangulation/triangulator.h>
+#include <types.h>
+
+namespace omg {
+
+// splits the domain into vertical strips with a similar expected number of triangles,
+// the cut lines are discretized according to the size function and the strips are meshed concurrently with Triangle,
+// the strips share the vertices on the cut lines, so the pieces form one conforming mesh
+class ParallelTriangleTriangulator : public Triangulator {
+public:
+    // num_strips = 0 uses one strip per OpenMP thread
+    explicit ParallelTriangleTriangulator(real_t min_angle = 33, std::size_t num_strips = 0);
+
+    // start every strip from a lattice of points inside it, see InteriorSeeder
+    inline void setInteriorSeeding(bool enable) { interior_seeding = enable; }
+
+    // the boundary and the cut lines are never split, keep_boundary has no effect
+    // the statistics are summed over all strips
+    TriangulationStats generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary = true) override;
+
+private:
+    const real_t min_angle;
+    const std::size_t num_strips;
+    bool interior_seeding = false;
+};
+
+}
@@ -0,0 +1,617 @@
+
+#include "region_remeshing.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <set>
+#include <unordered_set>
+
+#include <geometry/line_intersection.h>
+
+namespace omg {
+
+// points of the old mesh and of the new boundary are matched by their exact coordinates
+using PointKey = std::pair<real_t, real_t>;
+using SegmentKey = std::array<real_t, 4>;
+
+static inline PointKey pointKey(const vec2_t& p) {
+    return {p[0], p[1]};
+}
+
+static inline SegmentKey segmentKey(const vec2_t& a, const vec2_t& b) {
+    return {a[0], a[1], b[0], b[1]};
+}
+
+static inline vec2_t point2D(const Mesh& mesh, Mesh::VertexHandle vh) {
+    const vec3_t& p = mesh.point(vh);
+    return vec2_t(p[0], p[1]);
+}
+
+static inline real_t orientation(const vec2_t& a, const vec2_t& b, const vec2_t& c) {
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+static bool overlapsRegion(const std::array<vec2_t, 3>& triangle, const HEPolygon& region) {
+    for (const vec2_t& p : triangle) {
+        if (region.pointInPolygon(p) != OUTSIDE) {
+            return true;
+        }
+    }
+
+    for (HEPolygon::HalfEdgeHandle heh : region.halfEdges()) {
+        const vec2_t& p = region.startPoint(heh);
+
+        // region vertex inside of the counterclockwise triangle
+        if (orientation(triangle[0], triangle[1], p) >= 0 && orientation(triangle[1], triangle[2], p) >= 0 &&
+            orientation(triangle[2], triangle[0], p) >= 0) {
+            return true;
+        }
+
+        for (std::size_t k = 0; k < 3; k++) {
+            if (lineIntersection({p, region.endPoint(heh)}, {triangle[k], triangle[(k + 1) % 3]})) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+using FaceSet = std::unordered_set<int>;  // face indices
+
+static std::array<vec2_t, 3> facePoints(const Mesh& mesh, Mesh::FaceHandle fh) {
+    std::array<vec2_t, 3> triangle;
+    std::size_t k = 0;
+    for (const auto& vh : mesh.fv_range(fh)) {
+        triangle[k++] = point2D(mesh, vh);
+    }
+    return triangle;
+}
+
+static AxisAlignedBoundingBox faceBox(const Mesh& mesh, Mesh::FaceHandle fh) {
+    const std::array<vec2_t, 3> triangle = facePoints(mesh, fh);
+    return AxisAlignedBoundingBox(triangle[0]) + triangle[1] + triangle[2];
+}
+
+static bool overlaps(const AxisAlignedBoundingBox& a, const AxisAlignedBoundingBox& b) {
+    return a.max[0] >= b.min[0] && a.min[0] <= b.max[0] && a.max[1] >= b.min[1] && a.min[1] <= b.max[1];
+}
+
+static bool insideBox(const vec2_t& p, const AxisAlignedBoundingBox& box) {
+    return p[0] >= box.min[0] && p[0] <= box.max[0] && p[1] >= box.min[1] && p[1] <= box.max[1];
+}
+
+// walks from start through the face adjacency towards the point, returns the face containing the point
+// or the last face before the walk would leave the mesh
+static Mesh::FaceHandle walkTowards(const Mesh& mesh, Mesh::FaceHandle start, const vec2_t& p) {
+    Mesh::FaceHandle current = start;
+
+    // a step limit, walks in non-Delaunay meshes can cycle
+    for (std::size_t step = 0; step < mesh.n_faces(); step++) {
+
+        std::array<Mesh::HalfedgeHandle, 3> halfedges;
+        std::size_t k = 0;
+        for (const auto& heh : mesh.fh_range(current)) {
+            halfedges[k++] = heh;
+        }
+
+        // the first edge to test changes with every step to break cycles
+        Mesh::FaceHandle next;
+        for (std::size_t i = 0; i < 3 && !next.is_valid(); i++) {
+            const Mesh::HalfedgeHandle heh = halfedges[(i + step) % 3];
+
+            // the point is on the other side of the edge
+            if (orientation(point2D(mesh, mesh.from_vertex_handle(heh)), point2D(mesh, mesh.to_vertex_handle(heh)), p) < 0) {
+                next = mesh.face_handle(mesh.opposite_halfedge_handle(heh));
+            }
+        }
+
+        if (!next.is_valid()) {
+            return current;
+        }
+        current = next;
+    }
+    return current;
+}
+
+// faces overlapping the region, found by walking to the region and flooding the faces overlapping its bounding box
+static std::vector<Mesh::FaceHandle> findRegionFaces(const Mesh& mesh, const HEPolygon& region, FaceSet& removed) {
+    const AxisAlignedBoundingBox region_box = region.computeBoundingBox();
+
+    std::vector<vec2_t> targets;
+    for (HEPolygon::HalfEdgeHandle heh : region.halfEdges()) {
+        targets.push_back(region.startPoint(heh));
+    }
+    targets.push_back(region.getPointInPolygon());
+
+    std::vector<Mesh::FaceHandle> stack;
+    FaceSet visited;
+
+    // faces deleted by a previous splice stay in the mesh until its garbage collection
+    Mesh::FaceHandle start = *mesh.faces_sbegin();
+    for (const vec2_t& target : targets) {
+        start = walkTowards(mesh, start, target);
+
+        if (overlaps(faceBox(mesh, start), region_box) && visited.insert(start.idx()).second) {
+            stack.push_back(start);
+        }
+    }
+
+    // the walks are blocked by the boundary, e.g. if the region is behind an island
+    if (stack.empty()) {
+        for (const auto& fh : mesh.faces()) {
+            if (overlaps(faceBox(mesh, fh), region_box)) {
+                visited.insert(fh.idx());
+                stack.push_back(fh);
+            }
+        }
+    }
+
+    std::vector<Mesh::FaceHandle> faces;
+    while (!stack.empty()) {
+        const Mesh::FaceHandle fh = stack.back();
+        stack.pop_back();
+
+        if (overlapsRegion(facePoints(mesh, fh), region)) {
+            removed.insert(fh.idx());
+            faces.push_back(fh);
+        }
+
+        for (const auto& heh : mesh.fh_range(fh)) {
+            const Mesh::FaceHandle neighbor = mesh.face_handle(mesh.opposite_halfedge_handle(heh));
+
+            if (neighbor.is_valid() && visited.count(neighbor.idx()) == 0 &&
+                overlaps(faceBox(mesh, neighbor), region_box)) {
+
+                visited.insert(neighbor.idx());
+                stack.push_back(neighbor);
+            }
+        }
+    }
+    return faces;
+}
+
+static std::vector<Mesh::FaceHandle> selectFaces(const Mesh& mesh, const HEPolygon& region, std::size_t buffer_rings,
+                                                 FaceSet& removed) {
+
+    std::vector<Mesh::FaceHandle> faces = findRegionFaces(mesh, region, removed);
+
+    // rings of faces sharing a vertex
+    std::vector<Mesh::FaceHandle> front = faces;
+    for (std::size_t r = 0; r < buffer_rings; r++) {
+
+        std::vector<Mesh::FaceHandle> next;
+        for (Mesh::FaceHandle fh : front) {
+            for (const auto& vh : mesh.fv_range(fh)) {
+                for (const auto& neighbor : mesh.vf_range(vh)) {
+                    if (removed.insert(neighbor.idx()).second) {
+                        next.push_back(neighbor);
+                    }
+                }
+            }
+        }
+        faces.insert(faces.end(), next.begin(), next.end());
+        front = std::move(next);
+    }
+
+    return faces;
+}
+
+// number of separate fans of removed faces around the vertex
+static std::size_t countRemovedFans(const Mesh& mesh, Mesh::VertexHandle vh, const FaceSet& removed) {
+    std::vector<bool> slots;
+    for (const auto& heh : mesh.voh_range(vh)) {
+        const Mesh::FaceHandle fh = mesh.face_handle(heh);
+        slots.push_back(fh.is_valid() && removed.count(fh.idx()) != 0);
+    }
+
+    std::size_t fans = 0;
+    for (std::size_t i = 0; i < slots.size(); i++) {
+        if (slots[i] && !slots[(i + slots.size() - 1) % slots.size()]) {
+            fans++;
+        }
+    }
+    // all faces are removed
+    if (fans == 0 && !slots.empty() && slots[0]) {
+        fans = 1;
+    }
+    return fans;
+}
+
+// the faces around a vertex as wedges from the next to the previous vertex, which are unique on both sides,
+// a manifold vertex has one chain of wedges, which is closed for inner vertices
+static bool isSingleFan(const std::map<int, int>& wedges) {
+    std::set<int> previous;
+    for (const auto& [next, prev] : wedges) {
+        previous.insert(prev);
+    }
+
+    // an open fan has to start at its first wedge
+    int start = wedges.begin()->first;
+    for (const auto& [next, prev] : wedges) {
+        if (previous.count(next) == 0) {
+            start = next;
+            break;
+        }
+    }
+
+    std::size_t length = 0;
+    for (auto it = wedges.find(start); it != wedges.end() && length < wedges.size(); it = wedges.find(it->second)) {
+        length++;
+        if (it->second == start) {
+            break;
+        }
+    }
+    return length == wedges.size();
+}
+
+// where the cavity only touches itself at a vertex, the outline would visit the vertex twice,
+// the faces around such vertices are removed as well
+static void removePinchedVertices(const Mesh& mesh, FaceSet& removed, std::vector<Mesh::FaceHandle>& faces) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        std::set<Mesh::VertexHandle> vertices;
+        for (Mesh::FaceHandle fh : faces) {
+            for (const auto& vh : mesh.fv_range(fh)) {
+                vertices.insert(vh);
+            }
+        }
+
+        for (Mesh::VertexHandle vh : vertices) {
+            if (countRemovedFans(mesh, vh, removed) < 2) {
+                continue;
+            }
+
+            for (const auto& fh : mesh.vf_range(vh)) {
+                if (removed.insert(fh.idx()).second) {
+                    faces.push_back(fh);
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+// directed edges with the new domain on their left side, every point has one outgoing and one incoming edge
+class CavityOutline {
+public:
+    void addEdge(const vec2_t& a, const vec2_t& b) {
+        const std::size_t from = node(a);
+        const std::size_t to = node(b);
+
+        if (next[from] != NONE) {
+            throw std::runtime_error("Cavity outline is not closed, the boundary may only change inside of the region");
+        }
+        next[from] = to;
+        incoming[to]++;
+    }
+
+    std::vector<std::vector<vec2_t>> traceLoops() const {
+        for (std::size_t i = 0; i < points.size(); i++) {
+            if (next[i] == NONE || incoming[i] != 1) {
+                throw std::runtime_error("Cavity outline is not closed, the boundary may only change inside of the region");
+            }
+        }
+
+        std::vector<std::vector<vec2_t>> loops;
+        std::vector<bool> visited(points.size(), false);
+
+        for (std::size_t start = 0; start < points.size(); start++) {
+            if (visited[start]) {
+                continue;
+            }
+
+            loops.emplace_back();
+            for (std::size_t i = start; !visited[i]; i = next[i]) {
+                visited[i] = true;
+                loops.back().push_back(points[i]);
+            }
+        }
+        return loops;
+    }
+
+private:
+    static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+    std::map<PointKey, std::size_t> nodes;
+    std::vector<vec2_t> points;
+    std::vector<std::size_t> next;
+    std::vector<std::size_t> incoming;
+
+    std::size_t node(const vec2_t& p) {
+        const auto it = nodes.find(pointKey(p));
+        if (it != nodes.end()) {
+            return it->second;
+        }
+
+        nodes.emplace(pointKey(p), points.size());
+        points.push_back(p);
+        next.push_back(NONE);
+        incoming.push_back(0);
+        return points.size() - 1;
+    }
+};
+
+// twice the signed area, HEPolygon always stores its points counterclockwise
+static real_t signedArea(const std::vector<vec2_t>& loop) {
+    real_t area = 0;
+    for (std::size_t i = 0; i < loop.size(); i++) {
+        const vec2_t& p1 = loop[i];
+        const vec2_t& p2 = loop[(i + 1) % loop.size()];
+        area += (p1[0] + p2[0]) * (p2[1] - p1[1]);
+    }
+    return area;
+}
+
+// counterclockwise loops enclose a piece of the domain, clockwise loops are holes in the smallest piece around them
+static std::vector<Boundary> assembleComponents(const std::vector<std::vector<vec2_t>>& loops) {
+    std::vector<HEPolygon> outers;
+    std::vector<real_t> areas;
+    std::vector<HEPolygon> holes;
+
+    for (const std::vector<vec2_t>& loop : loops) {
+        HEPolygon poly(loop);
+        const real_t area = signedArea(loop);
+
+        if (area > 0) {
+            outers.push_back(std::move(poly));
+            areas.push_back(area);
+        } else {
+            holes.push_back(std::move(poly));
+        }
+    }
+
+    std::vector<Boundary> components(outers.size());
+    for (std::size_t i = 0; i < outers.size(); i++) {
+        components[i].setOuter(outers[i]);
+    }
+
+    for (const HEPolygon& hole : holes) {
+        const vec2_t p = hole.getPointInPolygon();
+
+        std::size_t best = outers.size();
+        for (std::size_t i = 0; i < outers.size(); i++) {
+            if (outers[i].pointInPolygon(p) == INSIDE && (best == outers.size() || areas[i] < areas[best])) {
+                best = i;
+            }
+        }
+
+        if (best == outers.size()) {
+            throw std::runtime_error("Hole in the cavity outside of the domain");
+        }
+        components[best].addIsland(hole);
+    }
+    return components;
+}
+
+Cavity extractCavity(const Mesh& mesh, const Boundary& boundary, const HEPolygon& region, std::size_t buffer_rings) {
+    if (mesh.faces_sbegin() == mesh.faces_end()) {
+        throw std::runtime_error("Mesh for region remeshing is empty");
+    }
+
+    FaceSet removed;
+    Cavity cavity;
+    cavity.faces = selectFaces(mesh, region, buffer_rings, removed);
+    removePinchedVertices(mesh, removed, cavity.faces);
+
+    const AxisAlignedBoundingBox region_box = region.computeBoundingBox();
+
+    CavityOutline outline;
+    std::set<PointKey> cavity_points;
+    std::set<Mesh::VertexHandle> cavity_vertices;
+    AxisAlignedBoundingBox cavity_box = region_box;
+
+    // edges to the kept faces are frozen, the removed face is on their left
+    for (Mesh::FaceHandle fh : cavity.faces) {
+        for (const auto& heh : mesh.fh_range(fh)) {
+            const vec2_t from = point2D(mesh, mesh.from_vertex_handle(heh));
+            cavity_points.insert(pointKey(from));
+            cavity_vertices.insert(mesh.from_vertex_handle(heh));
+            cavity_box += from;
+
+            const Mesh::FaceHandle opposite = mesh.face_handle(mesh.opposite_halfedge_handle(heh));
+            if (opposite.is_valid() && removed.count(opposite.idx()) == 0) {
+                outline.addEdge(from, point2D(mesh, mesh.to_vertex_handle(heh)));
+            }
+        }
+    }
+
+    // boundary edges of the kept faces at the cavity stay as they are
+    const auto is_kept_boundary = [&](Mesh::HalfedgeHandle inner) {
+        const Mesh::FaceHandle fh = mesh.face_handle(inner);
+        return fh.is_valid() && removed.count(fh.idx()) == 0 && mesh.is_boundary(mesh.opposite_halfedge_handle(inner));
+    };
+
+    std::set<SegmentKey> kept_boundary;
+    for (Mesh::VertexHandle vh : cavity_vertices) {
+        for (const auto& heh : mesh.voh_range(vh)) {
+            for (Mesh::HalfedgeHandle inner : {Mesh::HalfedgeHandle(heh), mesh.opposite_halfedge_handle(heh)}) {
+                if (is_kept_boundary(inner)) {
+                    kept_boundary.insert(segmentKey(point2D(mesh, mesh.from_vertex_handle(inner)),
+                                                    point2D(mesh, mesh.to_vertex_handle(inner))));
+                }
+            }
+        }
+    }
+
+    const auto inside_cavity = [&](const vec2_t& p) {
+        return cavity_points.count(pointKey(p)) != 0 || (insideBox(p, region_box) && region.pointInPolygon(p) != OUTSIDE);
+    };
+
+    // all other boundary segments at the cavity are new or belong to the removed faces,
+    // the polygons are counterclockwise, so the islands are reversed to have the domain on the left
+    std::vector<HEPolygon> polys = boundary.getIslands();
+    polys.push_back(boundary.getOuter());
+
+    for (std::size_t i = 0; i < polys.size(); i++) {
+        const bool is_island = i + 1 < polys.size();
+
+        for (HEPolygon::HalfEdgeHandle heh : polys[i].halfEdges()) {
+            vec2_t a = polys[i].startPoint(heh);
+            vec2_t b = polys[i].endPoint(heh);
+            if (is_island) {
+                std::swap(a, b);
+            }
+
+            if (!overlaps(AxisAlignedBoundingBox(a) + b, cavity_box)) {
+                continue;
+            }
+
+            if (kept_boundary.count(segmentKey(a, b)) != 0) {
+                continue;
+            }
+
+            const bool a_inside = inside_cavity(a);
+            const bool b_inside = inside_cavity(b);
+            if (!a_inside && !b_inside) {
+                continue;  // boundary of kept faces away from the cavity
+            }
+            if (!a_inside || !b_inside) {
+                throw std::runtime_error("Boundary changed outside of the region");
+            }
+
+            outline.addEdge(a, b);
+        }
+    }
+
+    cavity.components = assembleComponents(outline.traceLoops());
+    return cavity;
+}
+
+void spliceCavity(const Cavity& cavity, const std::vector<FlatMesh>& patches, Mesh& mesh) {
+    if (patches.size() != cavity.components.size()) {
+        throw std::runtime_error("Wrong number of cavity triangulations");
+    }
+
+    FaceSet removed;
+    for (Mesh::FaceHandle fh : cavity.faces) {
+        if (!fh.is_valid() || static_cast<std::size_t>(fh.idx()) >= mesh.n_faces() || mesh.status(fh).deleted()) {
+            throw std::runtime_error("Cavity does not belong to the mesh");
+        }
+        removed.insert(fh.idx());
+    }
+
+    const auto is_kept = [&](Mesh::FaceHandle fh) {
+        return fh.is_valid() && removed.count(fh.idx()) == 0;
+    };
+
+    // vertices of removed faces that also belong to kept faces stay, the outline edges have to be kept
+    std::map<PointKey, Mesh::VertexHandle> outline_vertices;
+    std::vector<Mesh::HalfedgeHandle> outline_edges;
+
+    for (Mesh::FaceHandle fh : cavity.faces) {
+        for (const auto& heh : mesh.fh_range(fh)) {
+            const Mesh::VertexHandle vh = mesh.from_vertex_handle(heh);
+            for (const auto& neighbor : mesh.vf_range(vh)) {
+                if (is_kept(neighbor)) {
+                    outline_vertices.emplace(pointKey(point2D(mesh, vh)), vh);
+                    break;
+                }
+            }
+
+            if (is_kept(mesh.face_handle(mesh.opposite_halfedge_handle(heh)))) {
+                outline_edges.push_back(heh);
+            }
+        }
+    }
+
+    // points on the outline are shared with the kept faces, all others are new,
+    // new points get the indices after the vertices of the mesh
+    const int num_vertices = static_cast<int>(mesh.n_vertices());
+
+    std::vector<vec2_t> new_points;
+    std::vector<FlatMesh::Triangle> triangles;
+    std::set<std::pair<int, int>> new_edges;
+
+    for (const FlatMesh& patch : patches) {
+
+        std::vector<int> patch_index(patch.numVertices());
+        for (std::size_t i = 0; i < patch.numVertices(); i++) {
+            const auto it = outline_vertices.find(pointKey(patch.getPoint(i)));
+
+            if (it != outline_vertices.end()) {
+                patch_index[i] = it->second.idx();
+            } else {
+                patch_index[i] = num_vertices + static_cast<int>(new_points.size());
+                new_points.push_back(patch.getPoint(i));
+            }
+        }
+
+        for (const FlatMesh::Triangle& t : patch.getTriangles()) {
+            const FlatMesh::Triangle mapped = {patch_index[t[0]], patch_index[t[1]], patch_index[t[2]]};
+            triangles.push_back(mapped);
+
+            for (std::size_t k = 0; k < 3; k++) {
+                const int from = mapped[k];
+                const int to = mapped[(k + 1) % 3];
+
+                if (!new_edges.emplace(from, to).second) {
+                    throw std::runtime_error("Triangulations of the cavity overlap");
+                }
+
+                // only the outline edges may be shared with the kept faces
+                if (from < num_vertices && to < num_vertices) {
+                    const Mesh::HalfedgeHandle heh = mesh.find_halfedge(Mesh::VertexHandle(from), Mesh::VertexHandle(to));
+                    if (heh.is_valid() && is_kept(mesh.face_handle(heh))) {
+                        throw std::runtime_error("Triangulation overlaps the kept faces");
+                    }
+                }
+            }
+        }
+    }
+
+    // the triangulator must keep the edges to the kept faces, otherwise the mesh has cracks
+    for (Mesh::HalfedgeHandle heh : outline_edges) {
+        const int from = mesh.from_vertex_handle(heh).idx();
+        const int to = mesh.to_vertex_handle(heh).idx();
+        if (new_edges.count({from, to}) == 0) {
+            throw std::runtime_error("Triangulation changed the outline of the cavity");
+        }
+    }
+
+    // add_face fails for vertices that would get more than one fan of faces, that is checked before the mesh is changed
+    std::map<int, std::map<int, int>> wedges;
+    for (const FlatMesh::Triangle& t : triangles) {
+        for (std::size_t k = 0; k < 3; k++) {
+            wedges[t[k]].emplace(t[(k + 1) % 3], t[(k + 2) % 3]);
+        }
+    }
+    for (const auto& [key, vh] : outline_vertices) {
+        std::map<int, int>& around = wedges[vh.idx()];
+        for (const auto& heh : mesh.voh_range(vh)) {
+            if (is_kept(mesh.face_handle(heh))) {
+                around.emplace(mesh.to_vertex_handle(heh).idx(),
+                               mesh.to_vertex_handle(mesh.next_halfedge_handle(heh)).idx());
+            }
+        }
+    }
+    for (const auto& [v, around] : wedges) {
+        if (!isSingleFan(around)) {
+            throw std::runtime_error("Triangulation of the cavity is not manifold");
+        }
+    }
+
+    // replace the faces, isolated vertices inside of the cavity are deleted
+    for (Mesh::FaceHandle fh : cavity.faces) {
+        mesh.delete_face(fh, true);
+    }
+
+    std::vector<Mesh::VertexHandle> new_vertices(new_points.size());
+    for (std::size_t i = 0; i < new_points.size(); i++) {
+        new_vertices[i] = mesh.add_vertex(toVec3(new_points[i]));
+    }
+
+    const auto handle = [&](int i) {
+        return i < num_vertices ? Mesh::VertexHandle(i) : new_vertices[i - num_vertices];
+    };
+
+    for (const FlatMesh::Triangle& t : triangles) {
+        if (!mesh.add_face(handle(t[0]), handle(t[1]), handle(t[2])).is_valid()) {
+            throw std::runtime_error("Could not add a triangle of the cavity");
+        }
+    }
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include <boundary/boundary.h>
+#include <geometry/he_polygon.h>
+#include <mesh/flat_mesh.h>
+#include <mesh/mesh.h>
+
+namespace omg {
+
+// the part of a mesh that is triangulated again after a local change of the boundary or the size function
+struct Cavity {
+    std::vector<Mesh::FaceHandle> faces;  // removed faces of the old mesh
+
+    // pieces of the new domain inside the cavity, their outlines consist of the edges between
+    // removed and kept faces, which must not be split, and of the new boundary
+    std::vector<Boundary> components;
+};
+
+// selects the faces overlapping region and buffer_rings rings of faces around them,
+// the faces are found by walking through the mesh to the region, so the work depends on the size of the cavity.
+// the boundary may only differ from the boundary of the mesh inside of region
+Cavity extractCavity(const Mesh& mesh, const Boundary& boundary, const HEPolygon& region, std::size_t buffer_rings);
+
+// replaces the removed faces with one triangulation per component, only the faces of the cavity are deleted and added,
+// throws without changing the mesh if a triangulation does not fit to the kept faces or is not manifold.
+// the removed elements are only marked as deleted, so the handles of the kept elements stay valid,
+// the caller compacts the mesh with garbage_collection(), e.g. once after several splices
+void spliceCavity(const Cavity& cavity, const std::vector<FlatMesh>& patches, Mesh& mesh);
+
+}
@@ -24,27 +24,52 @@ static void restrictToInt(const LineGraph& outline) {
 }
 
 // TriangleIn implementation
-template<typename io_t>
-TriangleIn<io_t>::TriangleIn(const Boundary& boundary) {
+static std::vector<vec2_t> pointsInHoles(const Boundary& boundary) {
+    std::vector<vec2_t> holes;
+
+    for (const HEPolygon& island : boundary.getIslands()) {
+        // get a point inside the polygon
+        holes.push_back(island.getPointInPolygon());
+    }
+    return holes;
+}
 
+static LineGraph combineBoundary(const Boundary& boundary) {
     // combine outer and holes
     std::vector<HEPolygon> polys = boundary.getIslands();
     polys.push_back(boundary.getOuter());
-    omg::LineGraph outline = LineGraph::combinePolygons(polys);
+    return LineGraph::combinePolygons(polys);
+}
+
+template<typename io_t>
+TriangleIn<io_t>::TriangleIn(const Boundary& boundary, const std::vector<vec2_t>& seeds)
+    : TriangleIn(combineBoundary(boundary), pointsInHoles(boundary), seeds) {}
+
+template<typename io_t>
+TriangleIn<io_t>::TriangleIn(const LineGraph& outline, const std::vector<vec2_t>& holes, const std::vector<vec2_t>& seeds) {
 
     restrictToInt(outline);
 
     const std::vector<vec2_t>& points = outline.getPoints();
     const std::vector<LineGraph::Edge>& edges = outline.getEdges();
 
+    if (!fitsInt(points.size() + seeds.size())) {
+        throw std::runtime_error("Too many interior seeds");
+    }
+
     // initialize input triangulateio struct
-    io.numberofpoints = points.size();
-    io.pointlist = new double[points.size() * 2];
+    io.numberofpoints = points.size() + seeds.size();
+    io.pointlist = new double[io.numberofpoints * 2];
     // copy points
     for (std::size_t i = 0; i < points.size(); i++) {
         io.pointlist[i * 2 + 0] = points[i][0];
         io.pointlist[i * 2 + 1] = points[i][1];
     }
+    // seeds after the outline, the segments only refer to the outline points
+    for (std::size_t i = 0; i < seeds.size(); i++) {
+        io.pointlist[(points.size() + i) * 2 + 0] = seeds[i][0];
+        io.pointlist[(points.size() + i) * 2 + 1] = seeds[i][1];
+    }
 
     io.numberofpointattributes = 0;
     io.pointattributelist = nullptr;
@@ -60,16 +85,11 @@ TriangleIn<io_t>::TriangleIn(const Boundary& boundary) {
     io.segmentmarkerlist = nullptr;
 
     // create holes
-    const std::vector<HEPolygon>& holes = boundary.getIslands();
     io.numberofholes = holes.size();
     io.holelist = new double[io.numberofholes * 2];
     for (int i = 0; i < io.numberofholes; i++) {
-
-        // get a point inside the polygon
-        const vec2_t center = holes[i].getPointInPolygon();
-
-        io.holelist[i * 2 + 0] = center[0];
-        io.holelist[i * 2 + 1] = center[1];
+        io.holelist[i * 2 + 0] = holes[i][0];
+        io.holelist[i * 2 + 1] = holes[i][1];
     }
 
     io.numberofregions = 0;
@@ -80,6 +100,7 @@ template<typename io_t>
 TriangleIn<io_t>::~TriangleIn() {
     delete[] io.pointlist;
     delete[] io.segmentlist;
+    delete[] io.holelist;
 }
 
 
@@ -108,36 +129,31 @@ TriangleOut<io_t>::~TriangleOut() {
 }
 
 template<typename io_t>
-void TriangleOut<io_t>::toMesh(Mesh& mesh) const {  // TODO: error checking
+void TriangleOut<io_t>::toFlatMesh(FlatMesh& mesh) const {
 
     if (io.numberofcorners != 3) {
         throw std::runtime_error("Invalid number of corners");
     }
 
-    // convert result to OpenMesh
-    // add points
-    std::vector<Mesh::VertexHandle> vertex_handles;
-    vertex_handles.reserve(io.numberofpoints);
+    mesh = FlatMesh(io.numberofpoints, io.numberoftriangles);
 
-    Mesh::Point vertex(0);
+    #pragma omp parallel for
     for (int i = 0; i < io.numberofpoints; i++) {
-        vertex[0] = io.pointlist[2 * i + 0];
-        vertex[1] = io.pointlist[2 * i + 1];
-
-        vertex_handles.push_back(mesh.add_vertex(vertex));
+        mesh.setPoint(i, {io.pointlist[2 * i + 0], io.pointlist[2 * i + 1]});
     }
 
-    // add triangles
-    Mesh::VertexHandle v0, v1, v2;
+    #pragma omp parallel for
     for (int i = 0; i < io.numberoftriangles; i++) {
-        v0 = vertex_handles[io.trianglelist[3 * i + 0]];
-        v1 = vertex_handles[io.trianglelist[3 * i + 1]];
-        v2 = vertex_handles[io.trianglelist[3 * i + 2]];
-
-        mesh.add_face(v0, v1, v2);
+        mesh.setTriangle(i, io.trianglelist[3 * i + 0], io.trianglelist[3 * i + 1], io.trianglelist[3 * i + 2]);
     }
 }
 
+template<typename io_t>
+std::size_t TriangleOut<io_t>::numBytes() const {
+    return static_cast<std::size_t>(io.numberofpoints) * 2 * sizeof(double)
+         + static_cast<std::size_t>(io.numberoftriangles) * io.numberofcorners * sizeof(int);
+}
+
 template class TriangleIn<jrs::triangulateio>;
 template class TriangleOut<jrs::triangulateio>;
 
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <boundary/boundary.h>
-#include <mesh/mesh.h>
+#include <mesh/flat_mesh.h>
 
 namespace omg {
 
@@ -10,7 +10,12 @@ namespace omg {
 template<typename io_t>
 class TriangleIn {
 public:
-    explicit TriangleIn(const Boundary& boundary);
+    // seeds are additional points inside the domain, see InteriorSeeder::generateSeeds
+    explicit TriangleIn(const Boundary& boundary, const std::vector<vec2_t>& seeds = {});
+
+    // segments of the outline with one point inside every hole
+    TriangleIn(const LineGraph& outline, const std::vector<vec2_t>& holes, const std::vector<vec2_t>& seeds = {});
+
     ~TriangleIn();
 
     io_t io;
@@ -22,7 +27,9 @@ public:
     TriangleOut();
     ~TriangleOut();
 
-    void toMesh(Mesh& mesh) const;
+    void toFlatMesh(FlatMesh& mesh) const;
+
+    std::size_t numBytes() const;
 
     io_t io;
 };
@@ -2,24 +2,26 @@
 #include "triangle_triangulator.h"
 
 #include <Triangle/jrs_triangle.h>
+#include <triangulation/interior_seeding.h>
 #include <triangulation/triangle_helper.h>
 #include <util.h>
 
 namespace omg {
 
-const SizeFunction* TriangleTriangulator::size_function;
+TriangleTriangulator::TriangleTriangulator(real_t min_angle) : min_angle(min_angle) {}
 
-TriangleTriangulator::TriangleTriangulator(real_t min_angle) : min_angle(min_angle) {
-    // init callback function to interact with Triangle
-    jrs::set_triunsuitable_callback(triunsuitable);
-}
-
-void TriangleTriangulator::generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary) {
-    size_function = &size;
+TriangulationStats TriangleTriangulator::generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary) {
 
     //ScopeTimer timer("Triangle generate mesh");
+    const Stopwatch total;
+    TriangulationStats stats;
+
+    std::vector<vec2_t> seeds;
+    if (interior_seeding) {
+        seeds = InteriorSeeder(size).generateSeeds(boundary);
+    }
 
-    TriangleIn<jrs::triangulateio> in(boundary);
+    TriangleIn<jrs::triangulateio> in(boundary, seeds);
     TriangleOut<jrs::triangulateio> out;
 
     // Q: no console output
@@ -44,21 +46,42 @@ void TriangleTriangulator::generateMesh(const Boundary& boundary, const SizeFunc
     // TODO: make this optional
     args.nobisect = keep_boundary;
 
-    jrs::triangulate(args.toString(), &in.io, &out.io, nullptr);
+    // the callback to interact with Triangle is set for this thread only
+    FastSizeQuery query(size);
+    const Stopwatch mesher;
+    {
+        const jrs::TriunsuitableScope callback(triunsuitable, &query);
+        jrs::triangulate(args.toString(), &in.io, &out.io, nullptr);
+    }
+
+    stats.mesher_time = mesher.elapsed();
+    stats.size_query = query.getStatistics();
+    stats.input_points = in.io.numberofpoints;
+    stats.steiner_points = out.io.numberofpoints - in.io.numberofpoints;
 
-    out.toMesh(out_mesh);
+    out.toFlatMesh(out_mesh);
+    stats.peak_output_bytes = out.numBytes() + out_mesh.numBytes();
+
+    // seeds in holes are not part of a triangle
+    if (interior_seeding) {
+        out_mesh.removeUnusedPoints();
+    }
 
-    size_function = nullptr;
+    stats.num_vertices = out_mesh.numVertices();
+    stats.num_triangles = out_mesh.numTriangles();
+    stats.total_time = total.elapsed();
+    return stats;
 }
 
-int TriangleTriangulator::triunsuitable(double* v1, double* v2, double* v3, double area) {
+int TriangleTriangulator::triunsuitable(double* v1, double* v2, double* v3, double area, void* user_data) {
     (void) area;  // unused
 
-    if (size_function == nullptr) {
-        throw std::runtime_error("size_function was null");
+    const FastSizeQuery* query = static_cast<const FastSizeQuery*>(user_data);
+    if (query == nullptr) {
+        throw std::runtime_error("size query was null");
     }
 
-    return !size_function->isTriangleGood(vec2_t(v1[0], v1[1]), vec2_t(v2[0], v2[1]), vec2_t(v3[0], v3[1]));
+    return !query->isTriangleGood(vec2_t(v1[0], v1[1]), vec2_t(v2[0], v2[1]), vec2_t(v3[0], v3[1]));
 }
 
 
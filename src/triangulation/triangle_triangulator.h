@@ -1,22 +1,27 @@
 #pragma once
 
+#include <size_function/fast_size_query.h>
 #include <triangulation/triangulator.h>
 #include <types.h>
 
 namespace omg {
 
+// several instances can generate meshes concurrently on different threads
 class TriangleTriangulator : public Triangulator {
 public:
     explicit TriangleTriangulator(real_t min_angle = 33);
 
-    void generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary = true) override;
+    // start from a lattice of points inside the domain, see InteriorSeeder
+    inline void setInteriorSeeding(bool enable) { interior_seeding = enable; }
 
-private:
-    static const SizeFunction* size_function;
+    TriangulationStats generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary = true) override;
 
-    static int triunsuitable(double* v1, double* v2, double* v3, double area);
+private:
+    // user_data is the FastSizeQuery of the current triangulation
+    static int triunsuitable(double* v1, double* v2, double* v3, double area, void* user_data);
 
     const real_t min_angle;
+    bool interior_seeding = false;
 };
 
 
@@ -0,0 +1,27 @@
+
+#include "triangulation_stats.h"
+
+#include <iostream>
+
+namespace omg {
+
+void TriangulationStats::print() const {
+    std::cout << "vertices: " << num_vertices << ", triangles: " << num_triangles << std::endl;
+    std::cout << "input points: " << input_points << ", steiner points: " << steiner_points << std::endl;
+    std::cout << "peak output: " << peak_output_bytes / (1024 * 1024) << " MB" << std::endl;
+
+    if (size_query.calls() > 0) {
+        std::cout << "triunsuitable calls: " << size_query.calls() << ", accept ratio: " << acceptRatio() << std::endl;
+        std::cout << "decided by block bounds: " << size_query.accepted + size_query.rejected
+                  << ", exact tests: " << size_query.exact << std::endl;
+    }
+
+    std::cout << "total: " << total_time << " s, mesher: " << mesher_time << " s, size queries: " << size_query.time
+              << " s, geometry: " << geometryTime() << " s";
+    if (build_time > 0) {
+        std::cout << ", mesh build: " << build_time << " s";
+    }
+    std::cout << std::endl;
+}
+
+}
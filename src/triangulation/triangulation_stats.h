@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+#include <size_function/fast_size_query.h>
+#include <types.h>
+
+namespace omg {
+
+// counters and timers of one triangulation, returned by the triangulators
+// times are in seconds, the size queries and the mesher time are summed over all threads
+struct TriangulationStats {
+    // triunsuitable callbacks, JIGSAW evaluates the size function internally and has none
+    FastSizeQuery::Statistics size_query;
+
+    std::size_t input_points = 0;  // boundary, cut lines and interior seeds
+    std::size_t steiner_points = 0;  // points inserted by the mesher
+
+    std::size_t num_vertices = 0;
+    std::size_t num_triangles = 0;
+
+    // largest amount of output buffers held at once, the mesher output and the FlatMesh
+    std::size_t peak_output_bytes = 0;
+
+    double total_time = 0;  // wall time of the whole call
+    double mesher_time = 0;  // inside Triangle or JIGSAW, including the size queries
+    double build_time = 0;  // building the halfedge structure in generateMesh
+
+    // fraction of the tested triangles that were good
+    inline double acceptRatio() const {
+        return size_query.calls() > 0 ? static_cast<double>(size_query.good()) / size_query.calls() : 0;
+    }
+
+    // mesher time without the size queries
+    inline double geometryTime() const { return mesher_time - size_query.time; }
+
+    void print() const;
+};
+
+}
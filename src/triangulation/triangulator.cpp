@@ -0,0 +1,56 @@
+
+#include "triangulator.h"
+
+#include <algorithm>
+
+#include <mesh/mesh_builder.h>
+#include <triangulation/region_remeshing.h>
+#include <util.h>
+
+namespace omg {
+
+TriangulationStats Triangulator::generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary) {
+    FlatMesh flat;
+    TriangulationStats stats = generateFlatMesh(boundary, size, flat, keep_boundary);
+
+    const Stopwatch build;
+    buildMesh(flat, out_mesh);
+
+    stats.build_time = build.elapsed();
+    stats.total_time += stats.build_time;
+    return stats;
+}
+
+TriangulationStats Triangulator::remeshRegion(const Boundary& boundary, const SizeFunction& size, const HEPolygon& region,
+                                              Mesh& mesh, std::size_t buffer_rings, bool collect_garbage) {
+    const Stopwatch total;
+
+    const Cavity cavity = extractCavity(mesh, boundary, region, buffer_rings);
+
+    TriangulationStats stats;
+    std::vector<FlatMesh> patches(cavity.components.size());
+
+    for (std::size_t i = 0; i < patches.size(); i++) {
+        const TriangulationStats s = generateFlatMesh(cavity.components[i], size, patches[i], true);
+
+        stats.size_query += s.size_query;
+        stats.input_points += s.input_points;
+        stats.steiner_points += s.steiner_points;
+        stats.peak_output_bytes = std::max(stats.peak_output_bytes, s.peak_output_bytes);
+        stats.mesher_time += s.mesher_time;
+    }
+
+    const Stopwatch build;
+    spliceCavity(cavity, patches, mesh);
+    if (collect_garbage) {
+        mesh.garbage_collection();
+    }
+    stats.build_time = build.elapsed();
+
+    stats.num_vertices = mesh.n_vertices();
+    stats.num_triangles = mesh.n_faces();
+    stats.total_time = total.elapsed();
+    return stats;
+}
+
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <boundary/boundary.h>
+#include <geometry/he_polygon.h>
+#include <mesh/flat_mesh.h>
 #include <mesh/mesh.h>
 #include <size_function/size_function.h>
+#include <triangulation/triangulation_stats.h>
 
 namespace omg {
 
@@ -11,7 +14,20 @@ public:
     Triangulator() {}
     virtual ~Triangulator() {}
 
-    virtual void generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary = true) = 0;
+    // only the point and triangle arrays, enough if the mesh is just written
+    virtual TriangulationStats generateFlatMesh(const Boundary& boundary, const SizeFunction& size, FlatMesh& out_mesh, bool keep_boundary = true) = 0;
+
+    // builds the halfedge structure from generateFlatMesh
+    virtual TriangulationStats generateMesh(const Boundary& boundary, const SizeFunction& size, Mesh& out_mesh, bool keep_boundary = true);
+
+    // triangulates only the faces of a previous mesh overlapping region and buffer_rings rings around them again,
+    // the edges to the kept faces are frozen, mesh must have been generated with keep_boundary
+    // size and boundary may only have changed inside of region, throws without changing the mesh if the boundary
+    // changed outside or the triangulator splits the frozen edges
+    // without collect_garbage the removed elements stay marked as deleted and are counted in the stats,
+    // several regions can be remeshed that way before the mesh is compacted once
+    virtual TriangulationStats remeshRegion(const Boundary& boundary, const SizeFunction& size, const HEPolygon& region,
+                                            Mesh& mesh, std::size_t buffer_rings = 1, bool collect_garbage = true);
 };
 
 }
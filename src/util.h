@@ -67,6 +67,19 @@ private:
     const std::string msg;
 };
 
+// seconds since construction without any output, for statistics
+class Stopwatch {
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    inline double elapsed() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    const std::chrono::steady_clock::time_point start;
+};
+
 template <typename Iter, typename IndexIter>
 Iter removeByIndices(Iter first, Iter last, IndexIter ifirst, IndexIter ilast) {
     // by papagaga from https://codereview.stackexchange.com/questions/206686/removing-by-indices-several-elements-from-a-vector